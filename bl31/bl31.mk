@@ -41,6 +41,7 @@ BL31_SOURCES		+=	bl31/bl31_main.c				\
 				bl31/aarch64/crash_reporting.S			\
 				lib/cpus/aarch64/cpu_helpers.S			\
 				lib/locks/exclusive/spinlock.S			\
+				lib/locks/exclusive/ticket_lock.S		\
 				services/std_svc/std_svc_setup.c		\
 				services/std_svc/psci/psci_afflvl_off.c		\
 				services/std_svc/psci/psci_afflvl_on.c		\
@@ -50,10 +51,14 @@ BL31_SOURCES		+=	bl31/bl31_main.c				\
 				services/std_svc/psci/psci_helpers.S		\
 				services/std_svc/psci/psci_main.c		\
 				services/std_svc/psci/psci_setup.c		\
-				services/std_svc/psci/psci_system_off.c
+				services/std_svc/psci/psci_system_off.c		\
+				services/sip_svc/sip_svc_setup.c
 
 ifeq (${USE_COHERENT_MEM}, 1)
 BL31_SOURCES		+=	lib/locks/bakery/bakery_lock_coherent.c
+ifeq (${BAKERY_LOCK_BENCHMARK}, 1)
+BL31_SOURCES		+=	lib/locks/bakery/bakery_lock_bench.c
+endif
 else
 BL31_SOURCES		+=	lib/locks/bakery/bakery_lock_normal.c
 endif
@@ -75,3 +80,74 @@ endif
 
 $(eval $(call assert_boolean,CRASH_REPORTING))
 $(eval $(call add_define,CRASH_REPORTING))
+
+# Flag used to indicate if histograms of the latency of handing over S-EL1
+# interrupts to the Secure Payload should be maintained in BL3-1
+INTR_LATENCY_STATS	:=	0
+
+ifeq (${INTR_LATENCY_STATS}, 1)
+BL31_SOURCES		+=	bl31/intr_lat_stats.c
+endif
+
+$(eval $(call assert_boolean,INTR_LATENCY_STATS))
+$(eval $(call add_define,INTR_LATENCY_STATS))
+
+# Flag used to indicate if the PSCI_STAT_RESIDENCY and PSCI_STAT_COUNT calls
+# should be supported by accounting the time spent in each power state
+ENABLE_PSCI_STAT	:=	0
+
+ifeq (${ENABLE_PSCI_STAT}, 1)
+BL31_SOURCES		+=	services/std_svc/psci/psci_stat.c
+endif
+
+$(eval $(call assert_boolean,ENABLE_PSCI_STAT))
+$(eval $(call add_define,ENABLE_PSCI_STAT))
+
+# Flag used to place the lock data of each cpu in a bakery lock allocated in
+# coherent memory in its own cache line
+BAKERY_LOCK_PADDED	:=	0
+
+$(eval $(call assert_boolean,BAKERY_LOCK_PADDED))
+$(eval $(call add_define,BAKERY_LOCK_PADDED))
+
+# Flag used to include a microbenchmark of the bakery lock in coherent memory
+# which is run through a SiP Service call
+BAKERY_LOCK_BENCHMARK	:=	0
+
+ifeq (${BAKERY_LOCK_BENCHMARK}, 1)
+ifneq (${USE_COHERENT_MEM}, 1)
+$(error "BAKERY_LOCK_BENCHMARK requires USE_COHERENT_MEM=1")
+endif
+endif
+
+$(eval $(call assert_boolean,BAKERY_LOCK_BENCHMARK))
+$(eval $(call add_define,BAKERY_LOCK_BENCHMARK))
+
+# Flag used to indicate that the cpus are coherent as soon as they are powered
+# up and stay coherent until they are powered down. The PSCI implementation
+# then keeps the data cache enabled and uses ticket locks built on the
+# exclusive monitors instead of bakery locks
+HW_ASSISTED_COHERENCY	:=	0
+
+ifeq (${HW_ASSISTED_COHERENCY}, 1)
+ifeq (${USE_COHERENT_MEM}, 1)
+$(error "HW_ASSISTED_COHERENCY requires USE_COHERENT_MEM=0")
+endif
+endif
+
+$(eval $(call assert_boolean,HW_ASSISTED_COHERENCY))
+$(eval $(call add_define,HW_ASSISTED_COHERENCY))
+
+# Flag used to collect statistics of the bakery and spin locks in BL3-1, which
+# are reported through a SiP Service call
+LOCK_STATS		:=	0
+
+ifeq (${LOCK_STATS}, 1)
+ifneq (${USE_COHERENT_MEM}, 1)
+$(error "LOCK_STATS requires USE_COHERENT_MEM=1")
+endif
+BL31_SOURCES		+=	lib/locks/lock_stats.c
+endif
+
+$(eval $(call assert_boolean,LOCK_STATS))
+$(eval $(call add_define,LOCK_STATS))
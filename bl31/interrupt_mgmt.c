@@ -67,15 +67,26 @@ typedef struct intr_type_desc {
 static intr_type_desc_t intr_type_descs[MAX_INTR_TYPES];
 
 /*******************************************************************************
- * This function validates the interrupt type. EL3 interrupts are currently not
- * supported.
+ * Local structure and corresponding array to keep track of the handlers
+ * registered for individual interrupt ids which are handled in EL3. These
+ * interrupts are of type INTR_TYPE_EL3 and are demultiplexed by the framework
+ * through the handler it registers for this type.
+ ******************************************************************************/
+typedef struct intr_id_desc {
+	interrupt_type_handler_t handler;
+	uint32_t id;
+} intr_id_desc_t;
+
+static intr_id_desc_t intr_id_descs[MAX_EL3_INTR_HANDLERS];
+static uint32_t intr_id_descs_num;
+
+/*******************************************************************************
+ * This function validates the interrupt type.
  ******************************************************************************/
 static int32_t validate_interrupt_type(uint32_t type)
 {
-	if (type == INTR_TYPE_EL3)
-		return -ENOTSUP;
-
-	if (type != INTR_TYPE_S_EL1 && type != INTR_TYPE_NS)
+	if (type != INTR_TYPE_S_EL1 && type != INTR_TYPE_NS &&
+	    type != INTR_TYPE_EL3)
 		return -EINVAL;
 
 	return 0;
@@ -95,9 +106,42 @@ static int32_t validate_routing_model(uint32_t type, uint32_t flags)
 	if (type == INTR_TYPE_NS)
 		return validate_ns_interrupt_rm(flags);
 
+	if (type == INTR_TYPE_EL3)
+		return validate_el3_interrupt_rm(flags);
+
 	return -EINVAL;
 }
 
+/*******************************************************************************
+ * This function checks that the routing model in 'flags' does not conflict
+ * with that of another interrupt type with a registered handler which the
+ * platform signals on the same line (e.g. S-EL1 and EL3 interrupts which are
+ * both group0 interrupts signalled as FIQs on GICv2). Such types share the
+ * SCR_EL3 bit and so must be routed identically in each security state.
+ ******************************************************************************/
+static int32_t validate_routing_model_line(uint32_t type, uint32_t flags)
+{
+	uint32_t other, ss;
+
+	for (other = 0; other < MAX_INTR_TYPES; other++) {
+		if (other == type || !intr_type_descs[other].handler)
+			continue;
+
+		for (ss = SECURE; ss <= NON_SECURE; ss++) {
+			if (plat_interrupt_type_to_line(other, ss) !=
+			    plat_interrupt_type_to_line(type, ss))
+				continue;
+
+			if (get_interrupt_rm_flag(flags, ss) !=
+			    get_interrupt_rm_flag(intr_type_descs[other].flags,
+						  ss))
+				return -EINVAL;
+		}
+	}
+
+	return 0;
+}
+
 /*******************************************************************************
  * This function returns the cached copy of the SCR_EL3 which contains the
  * routing model (expressed through the IRQ and FIQ bits) for a security state
@@ -150,6 +194,10 @@ int32_t set_routing_model(uint32_t type, uint32_t flags)
 	if (rc)
 		return rc;
 
+	rc = validate_routing_model_line(type, flags);
+	if (rc)
+		return rc;
+
 	/* Update the routing model in internal data structures */
 	intr_type_descs[type].flags = flags;
 	set_scr_el3_from_rm(type, flags, SECURE);
@@ -243,3 +291,115 @@ interrupt_type_handler_t get_interrupt_type_handler(uint32_t type)
 	return intr_type_descs[type].handler;
 }
 
+/*******************************************************************************
+ * This function returns the handler registered for the interrupt 'id' to be
+ * handled in EL3. It returns NULL if no handler has been registered for it.
+ ******************************************************************************/
+interrupt_type_handler_t get_interrupt_handler(uint32_t id)
+{
+	uint32_t index;
+
+	for (index = 0; index < intr_id_descs_num; index++) {
+		if (intr_id_descs[index].id == id)
+			return intr_id_descs[index].handler;
+	}
+
+	return NULL;
+}
+
+/*******************************************************************************
+ * This function is registered by the framework as the handler for the EL3
+ * interrupt type. It acknowledges the highest priority pending interrupt, calls
+ * the handler registered for the id it got from the acknowledgement and then
+ * signals the end of the interrupt to the platform IC. A spurious interrupt is
+ * neither handled nor ended, as the interrupt which made the platform IC signal
+ * the exception may have been withdrawn. It continues to do so as long
+ * as the highest priority pending interrupt is an EL3 interrupt. This way,
+ * EL3 interrupts are serviced in the order of priority determined by the
+ * platform IC and back to back interrupts do not cost an additional exception
+ * entry and exit.
+ *
+ * The handlers registered for individual ids return to the same security state
+ * and context in which the interrupt was taken.
+ ******************************************************************************/
+static uint64_t el3_interrupt_handler(uint32_t id,
+				      uint32_t flags,
+				      void *handle,
+				      void *cookie)
+{
+	interrupt_type_handler_t handler;
+	uint32_t intr_raw;
+
+	do {
+		intr_raw = plat_ic_acknowledge_interrupt();
+		id = plat_ic_get_interrupt_id(intr_raw);
+		if (id == INTR_ID_UNAVAILABLE)
+			break;
+
+		handler = get_interrupt_handler(id);
+		assert(handler);
+
+		handler(id, flags, handle, cookie);
+		plat_ic_end_of_interrupt(intr_raw);
+	} while (plat_ic_get_pending_interrupt_type() == INTR_TYPE_EL3);
+
+	return (uint64_t) handle;
+}
+
+/*******************************************************************************
+ * This function registers a handler for the secure interrupt 'id' which will
+ * be handled in EL3. The interrupt is configured as an EL3 interrupt in the
+ * platform IC. The first registration also registers the framework handler for
+ * the EL3 interrupt type using the routing model specified in the 'flags'.
+ * Subsequent registrations must specify the same routing model. Acknowledging
+ * the interrupt and signalling its end to the platform IC is done by the
+ * framework around the call to 'handler'.
+ ******************************************************************************/
+int32_t register_interrupt_handler(uint32_t id,
+				   interrupt_type_handler_t handler,
+				   uint32_t flags)
+{
+	int32_t rc;
+
+	/* Validate the 'handler' parameter */
+	if (!handler)
+		return -EINVAL;
+
+	/* Validate the 'id' parameter before querying the platform IC */
+	if (id >= MAX_INTR_IDS)
+		return -EINVAL;
+
+	/* Only secure interrupts can be handled in EL3 */
+	if (plat_ic_get_interrupt_type(id) == INTR_TYPE_NS)
+		return -EINVAL;
+
+	/* Check if a handler has already been registered */
+	if (get_interrupt_handler(id))
+		return -EALREADY;
+
+	if (intr_id_descs_num == MAX_EL3_INTR_HANDLERS)
+		return -ENOMEM;
+
+	if (!intr_type_descs[INTR_TYPE_EL3].handler) {
+		rc = register_interrupt_type_handler(INTR_TYPE_EL3,
+						     el3_interrupt_handler,
+						     flags);
+		if (rc)
+			return rc;
+	} else if (intr_type_descs[INTR_TYPE_EL3].handler !=
+		   el3_interrupt_handler) {
+		/* The EL3 interrupt type is being handled by someone else */
+		return -EALREADY;
+	} else if (intr_type_descs[INTR_TYPE_EL3].flags != flags) {
+		return -EINVAL;
+	}
+
+	/* Save the handler and mark the interrupt as an EL3 interrupt */
+	intr_id_descs[intr_id_descs_num].id = id;
+	intr_id_descs[intr_id_descs_num].handler = handler;
+	intr_id_descs_num++;
+
+	plat_ic_set_interrupt_type(id, INTR_TYPE_EL3);
+
+	return 0;
+}
@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <arch.h>
+#include <arch_helpers.h>
+#include <assert.h>
+#include <errno.h>
+#include <interrupt_mgmt.h>
+#include <platform.h>
+#include <platform_def.h>
+#include <stdint.h>
+
+/*******************************************************************************
+ * Per-cpu interrupt latency statistics. 'entry_ts' and 'handoff_ts' hold the
+ * system counter value when the last interrupt was taken in EL3 and when it
+ * was handed over to S-EL1 respectively. A value of 0 means that the
+ * corresponding event has not happened for the interrupt being handled.
+ ******************************************************************************/
+typedef struct intr_lat_stats {
+	uint64_t entry_ts;
+	uint64_t handoff_ts;
+	uint64_t max[INTR_LAT_NUM_HISTS];
+	uint32_t hist[INTR_LAT_NUM_HISTS][INTR_LAT_NUM_BUCKETS];
+} __aligned(CACHE_WRITEBACK_GRANULE) intr_lat_stats_t;
+
+static intr_lat_stats_t intr_lat_stats[PLATFORM_CORE_COUNT];
+
+/*******************************************************************************
+ * This function accounts the latency between the timestamp 'start' and the
+ * current value of the system counter in the histogram 'hist' of the current
+ * cpu.
+ ******************************************************************************/
+static void intr_lat_stats_account(intr_lat_stats_t *stats,
+				   uint32_t hist,
+				   uint64_t start)
+{
+	uint64_t delta;
+	uint32_t bucket;
+
+	delta = read_cntpct_el0() - start;
+
+	/* Use the position of the most significant bit as the bucket */
+	bucket = 63 - __builtin_clzll(delta | 1);
+	if (bucket >= INTR_LAT_NUM_BUCKETS)
+		bucket = INTR_LAT_NUM_BUCKETS - 1;
+
+	stats->hist[hist][bucket]++;
+	if (delta > stats->max[hist])
+		stats->max[hist] = delta;
+}
+
+/*******************************************************************************
+ * This function is called by the interrupt exception vectors upon entry into
+ * EL3 to record the timestamp of the interrupt.
+ ******************************************************************************/
+void intr_lat_stats_mark_entry(void)
+{
+	intr_lat_stats_t *stats;
+
+	stats = &intr_lat_stats[platform_get_core_pos(read_mpidr())];
+	stats->entry_ts = read_cntpct_el0();
+}
+
+/*******************************************************************************
+ * This function is called by a Secure Payload Dispatcher just before it hands
+ * over a S-EL1 interrupt to the Secure Payload. It accounts the time since
+ * the interrupt was taken in EL3.
+ ******************************************************************************/
+void intr_lat_stats_mark_handoff(void)
+{
+	intr_lat_stats_t *stats;
+
+	stats = &intr_lat_stats[platform_get_core_pos(read_mpidr())];
+	if (stats->entry_ts) {
+		intr_lat_stats_account(stats, INTR_LAT_ENTRY_TO_HANDOFF,
+				       stats->entry_ts);
+		stats->entry_ts = 0;
+	}
+
+	stats->handoff_ts = read_cntpct_el0();
+}
+
+/*******************************************************************************
+ * This function is called by a Secure Payload Dispatcher when the Secure
+ * Payload signals that it has finished handling a S-EL1 interrupt. It accounts
+ * the time since the interrupt was handed over to the Secure Payload.
+ ******************************************************************************/
+void intr_lat_stats_mark_return(void)
+{
+	intr_lat_stats_t *stats;
+
+	stats = &intr_lat_stats[platform_get_core_pos(read_mpidr())];
+	if (stats->handoff_ts) {
+		intr_lat_stats_account(stats, INTR_LAT_HANDOFF_TO_RETURN,
+				       stats->handoff_ts);
+		stats->handoff_ts = 0;
+	}
+}
+
+/*******************************************************************************
+ * This function returns the count in the 'bucket' of the histogram 'hist' and
+ * the maximum latency recorded in that histogram for the cpu identified by
+ * 'mpidr'. The latencies are expressed in system counter ticks.
+ ******************************************************************************/
+int32_t intr_lat_stats_get(uint64_t mpidr,
+			   uint32_t hist,
+			   uint32_t bucket,
+			   uint64_t *count,
+			   uint64_t *max)
+{
+	intr_lat_stats_t *stats;
+	uint32_t cpu_idx;
+
+	assert(count && max);
+
+	if (hist >= INTR_LAT_NUM_HISTS || bucket >= INTR_LAT_NUM_BUCKETS)
+		return -EINVAL;
+
+	cpu_idx = platform_get_core_pos(mpidr);
+	if (cpu_idx >= PLATFORM_CORE_COUNT)
+		return -EINVAL;
+
+	stats = &intr_lat_stats[cpu_idx];
+	*count = stats->hist[hist][bucket];
+	*max = stats->max[hist];
+
+	return 0;
+}
@@ -49,6 +49,14 @@ TSP_INIT_ASYNC         :=      0
 $(eval $(call assert_boolean,TSP_INIT_ASYNC))
 $(eval $(call add_define,TSP_INIT_ASYNC))
 
+# This flag determines if the TSP arms a software timer firing every 0.5 second
+# on each cpu (0) or only programs the Secure Physical Timer when a software
+# timer has been armed (1).
+TSP_TIMER_TICKLESS	:=	0
+
+$(eval $(call assert_boolean,TSP_TIMER_TICKLESS))
+$(eval $(call add_define,TSP_TIMER_TICKLESS))
+
 # Include the platform-specific TSP Makefile
 # If no platform-specific TSP Makefile exists, it means TSP is not supported
 # on this platform.
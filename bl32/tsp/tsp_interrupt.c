@@ -87,6 +87,19 @@ int32_t tsp_fiq_handler(void)
 	 */
 	id = plat_ic_get_pending_interrupt_id();
 
+#if TSPD_STD_SMC_WORKER
+	/*
+	 * The TSPD wakes up the worker cpu with an SGI to run the requests
+	 * handed over by other cpus. It does so once this FIQ is handled, so
+	 * there is nothing to do here other than completing the interrupt.
+	 */
+	if (id == TSP_IRQ_WORKER_SGI) {
+		plat_ic_end_of_interrupt(plat_ic_acknowledge_interrupt());
+		tsp_stats[linear_id].fiq_count++;
+		return 0;
+	}
+#endif
+
 	/* TSP can only handle the secure physical timer interrupt */
 	if (id != TSP_IRQ_SEC_PHY_TIMER)
 		return TSP_EL3_FIQ;
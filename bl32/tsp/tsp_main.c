@@ -29,11 +29,13 @@
  */
 
 #include <arch_helpers.h>
+#include <assert.h>
 #include <bl_common.h>
 #include <debug.h>
 #include <platform.h>
 #include <platform_def.h>
 #include <platform_tsp.h>
+#include <runtime_svc.h>
 #include <spinlock.h>
 #include <tsp.h>
 #include "tsp_private.h"
@@ -61,6 +63,22 @@ static tsp_args_t tsp_smc_args[PLATFORM_CORE_COUNT];
  ******************************************************************************/
 work_statistics_t tsp_stats[PLATFORM_CORE_COUNT];
 
+/*******************************************************************************
+ * Per cpu buffer of cache lines used by the cache variant of TSP_BENCH
+ ******************************************************************************/
+static uint64_t tsp_bench_lines[PLATFORM_CORE_COUNT][TSP_BENCH_MAX_LINES]
+			       [CACHE_WRITEBACK_GRANULE >> 3]
+			       __aligned(CACHE_WRITEBACK_GRANULE);
+
+#if TSPD_NUM_STD_CTX > 1
+/*******************************************************************************
+ * Per cpu stacks for the std smcs run in the additional TSPD contexts. Those
+ * run in the first context use the normal stack of the cpu.
+ ******************************************************************************/
+static uint64_t tsp_std_ctx_stacks[PLATFORM_CORE_COUNT][TSPD_NUM_STD_CTX - 1]
+				  [PLATFORM_STACK_SIZE >> 3] __aligned(16);
+#endif
+
 /*******************************************************************************
  * The BL32 memory footprint starts with an RO sections and ends
  * with the linker symbol __BL32_END__. Use it to find the memory size
@@ -360,6 +378,94 @@ tsp_args_t *tsp_system_reset_main(uint64_t arg0,
 	return set_smc_args(TSP_SYSTEM_RESET_DONE, 0, 0, 0, 0, 0, 0, 0);
 }
 
+#if CTX_INCLUDE_FPREGS
+/*******************************************************************************
+ * This function writes all the FP/SIMD registers. They are only saved and
+ * restored by BL3-1 around world switches if CTX_INCLUDE_FPREGS is set, so it
+ * must not be called otherwise.
+ ******************************************************************************/
+static void tsp_bench_fp(void)
+{
+	write_cpacr(read_cpacr() | CPACR_EL1_FPEN(CPACR_EL1_FP_TRAP_NONE));
+	isb();
+
+	__asm__ volatile("movi	v0.2d, #0\n"	"movi	v1.2d, #0\n"
+			 "movi	v2.2d, #0\n"	"movi	v3.2d, #0\n"
+			 "movi	v4.2d, #0\n"	"movi	v5.2d, #0\n"
+			 "movi	v6.2d, #0\n"	"movi	v7.2d, #0\n"
+			 "movi	v8.2d, #0\n"	"movi	v9.2d, #0\n"
+			 "movi	v10.2d, #0\n"	"movi	v11.2d, #0\n"
+			 "movi	v12.2d, #0\n"	"movi	v13.2d, #0\n"
+			 "movi	v14.2d, #0\n"	"movi	v15.2d, #0\n"
+			 "movi	v16.2d, #0\n"	"movi	v17.2d, #0\n"
+			 "movi	v18.2d, #0\n"	"movi	v19.2d, #0\n"
+			 "movi	v20.2d, #0\n"	"movi	v21.2d, #0\n"
+			 "movi	v22.2d, #0\n"	"movi	v23.2d, #0\n"
+			 "movi	v24.2d, #0\n"	"movi	v25.2d, #0\n"
+			 "movi	v26.2d, #0\n"	"movi	v27.2d, #0\n"
+			 "movi	v28.2d, #0\n"	"movi	v29.2d, #0\n"
+			 "movi	v30.2d, #0\n"	"movi	v31.2d, #0\n");
+}
+#endif
+
+/*******************************************************************************
+ * This function handles the TSP_BENCH service. It is kept apart from the
+ * arithmetic services so that a call only costs the world switches and the
+ * requested variant. The system counter is read when the TSP starts handling
+ * the call, around the variant and just before returning, so that the normal
+ * world can split the round trip into its stages.
+ ******************************************************************************/
+static tsp_args_t *tsp_bench_handler(uint64_t func,
+				     uint64_t variant,
+				     uint64_t lines)
+{
+	uint64_t entry_ts, start_ts, end_ts;
+	uint64_t status = 0;
+	uint32_t linear_id;
+	uint32_t i;
+
+	isb();
+	entry_ts = read_cntpct_el0();
+
+	linear_id = platform_get_core_pos(read_mpidr());
+
+	start_ts = read_cntpct_el0();
+	switch (variant) {
+	case TSP_BENCH_NULL:
+		break;
+	case TSP_BENCH_FP:
+#if CTX_INCLUDE_FPREGS
+		tsp_bench_fp();
+#else
+		status = SMC_UNK;
+#endif
+		break;
+	case TSP_BENCH_CACHE:
+		if (lines > TSP_BENCH_MAX_LINES)
+			lines = TSP_BENCH_MAX_LINES;
+		for (i = 0; i < lines; i++)
+			tsp_bench_lines[linear_id][i][0]++;
+		dsb();
+		break;
+	default:
+		status = SMC_UNK;
+		break;
+	}
+	isb();
+	end_ts = read_cntpct_el0();
+
+#if TSPD_NUM_STD_CTX > 1
+	/* See tsp_smc_handler() */
+	write_daifset(DAIF_FIQ_BIT | DAIF_IRQ_BIT);
+#endif
+
+	return set_smc_args(func, status,
+			    entry_ts,
+			    read_cntpct_el0(),
+			    end_ts - start_ts,
+			    0, 0, 0);
+}
+
 /*******************************************************************************
  * TSP fast smc handler. The secure monitor jumps to this function by
  * doing the ERET after populating X0-X7 registers. The arguments are received
@@ -377,8 +483,15 @@ tsp_args_t *tsp_smc_handler(uint64_t func,
 {
 	uint64_t results[2];
 	uint64_t service_args[2];
-	uint64_t mpidr = read_mpidr();
-	uint32_t linear_id = platform_get_core_pos(mpidr);
+	uint64_t mpidr;
+	uint32_t linear_id;
+
+	/* Benchmark calls must not pay for the rest of this handler */
+	if (TSP_BARE_FID(func) == TSP_BENCH)
+		return tsp_bench_handler(func, arg1, arg2);
+
+	mpidr = read_mpidr();
+	linear_id = platform_get_core_pos(mpidr);
 
 	/* Update this cpu's statistics */
 	tsp_stats[linear_id].smc_count++;
@@ -423,9 +536,35 @@ tsp_args_t *tsp_smc_handler(uint64_t func,
 		break;
 	}
 
+#if TSPD_NUM_STD_CTX > 1
+	/*
+	 * The results are passed through a per cpu structure. Another std smc
+	 * could overwrite them if this one was preempted before returning them.
+	 */
+	write_daifset(DAIF_FIQ_BIT | DAIF_IRQ_BIT);
+#endif
+
 	return set_smc_args(func, 0,
 			    results[0],
 			    results[1],
 			    0, 0, 0, 0);
 }
 
+#if TSPD_NUM_STD_CTX > 1
+/*******************************************************************************
+ * This function returns the top of the stack on which the TSP runs a std smc
+ * in the TSPD context 'idx' on the cpu 'mpidr'.
+ ******************************************************************************/
+uint64_t tsp_get_std_ctx_stack(uint64_t mpidr, uint32_t idx)
+{
+	uint32_t linear_id = platform_get_core_pos(mpidr);
+
+	assert(idx < TSPD_NUM_STD_CTX);
+	if (idx == 0)
+		return platform_get_stack(mpidr);
+
+	return (uint64_t)&tsp_std_ctx_stacks[linear_id][idx - 1]
+					    [PLATFORM_STACK_SIZE >> 3];
+}
+#endif
+
@@ -53,6 +53,13 @@
 #include <tsp.h>
 
 
+/* Software timer run on the cpu which armed it once 'deadline' has passed */
+typedef struct tsp_timer {
+	uint64_t deadline;		/* Physical counter value to fire at */
+	void (*handler)(struct tsp_timer *timer);
+	struct tsp_timer *next;		/* Next timer in deadline order */
+} tsp_timer_t;
+
 typedef struct work_statistics {
 	uint32_t fiq_count;		/* Number of FIQs on this cpu */
 	uint32_t irq_count;		/* Number of IRQs on this cpu */
@@ -99,6 +106,9 @@ tsp_args_t *tsp_cpu_suspend_main(uint64_t arg0,
 				 uint64_t arg6,
 				 uint64_t arg7);
 tsp_args_t *tsp_cpu_on_main(void);
+#if TSPD_NUM_STD_CTX > 1
+uint64_t tsp_get_std_ctx_stack(uint64_t mpidr, uint32_t idx);
+#endif
 tsp_args_t *tsp_cpu_off_main(uint64_t arg0,
 			     uint64_t arg1,
 			     uint64_t arg2,
@@ -114,6 +124,10 @@ void tsp_generic_timer_handler(void);
 void tsp_generic_timer_stop(void);
 void tsp_generic_timer_save(void);
 void tsp_generic_timer_restore(void);
+void tsp_timer_arm(tsp_timer_t *timer,
+		   uint64_t deadline,
+		   void (*handler)(tsp_timer_t *timer));
+void tsp_timer_cancel(tsp_timer_t *timer);
 
 /* FIQ management functions */
 void tsp_update_sync_fiq_stats(uint32_t type, uint64_t elr_el3);
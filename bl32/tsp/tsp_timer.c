@@ -29,31 +29,64 @@
  */
 #include <arch_helpers.h>
 #include <assert.h>
+#include <debug.h>
 #include <platform.h>
 #include "tsp_private.h"
 
 /*******************************************************************************
  * Data structure to keep track of per-cpu secure generic timer context across
- * power management operations.
+ * power management operations. The secure physical timer is programmed with
+ * the deadline of the first software timer in the 'timers' list, which is
+ * sorted by deadline, and disabled when the list is empty. The number of
+ * software timers run and the largest lateness of one when it was run, in
+ * counter ticks, are accounted.
  ******************************************************************************/
 typedef struct timer_context {
 	uint64_t cval;
 	uint32_t ctl;
+	uint32_t fire_count;
+	uint64_t late_max;
+	tsp_timer_t *timers;
 } timer_context_t;
 
 static timer_context_t pcpu_timer_context[PLATFORM_CORE_COUNT];
 
+#if !TSP_TIMER_TICKLESS
+/* Software timer firing every 0.5 second on each cpu for testing purposes */
+static tsp_timer_t pcpu_tick_timer[PLATFORM_CORE_COUNT];
+
+static void tsp_tick_timer_handler(tsp_timer_t *timer)
+{
+	uint64_t period = read_cntfrq_el0() >> 1;
+	uint64_t deadline = timer->deadline + period;
+	uint64_t now = read_cntpct_el0();
+
+	/*
+	 * Keep to the period regardless of how late this tick was run, but
+	 * skip the ticks missed e.g. while this cpu was suspended rather than
+	 * running each of them late.
+	 */
+	if (deadline <= now)
+		deadline += ((now - deadline) / period + 1) * period;
+
+	tsp_timer_arm(timer, deadline, tsp_tick_timer_handler);
+}
+#endif
+
 /*******************************************************************************
- * This function initializes the generic timer to fire every 0.5 second
+ * This function programs the secure physical timer to fire at the deadline of
+ * the first software timer of this cpu, or disables it if there is none.
  ******************************************************************************/
-void tsp_generic_timer_start(void)
+static void tsp_generic_timer_program(timer_context_t *ctx)
 {
-	uint64_t cval;
 	uint32_t ctl = 0;
 
-	/* The timer will fire every 0.5 second */
-	cval = read_cntpct_el0() + (read_cntfrq_el0() >> 1);
-	write_cntps_cval_el1(cval);
+	if (!ctx->timers) {
+		write_cntps_ctl_el1(0);
+		return;
+	}
+
+	write_cntps_cval_el1(ctx->timers->deadline);
 
 	/* Enable the secure physical timer */
 	set_cntp_ctl_enable(ctl);
@@ -61,10 +94,113 @@ void tsp_generic_timer_start(void)
 }
 
 /*******************************************************************************
- * This function deasserts the timer interrupt and sets it up again
+ * This function removes 'timer' from the list of this cpu if it is in it. It
+ * returns 1 if it was the first timer in the list.
+ ******************************************************************************/
+static int tsp_timer_unlink(timer_context_t *ctx, tsp_timer_t *timer)
+{
+	tsp_timer_t **prev;
+
+	for (prev = &ctx->timers; *prev; prev = &(*prev)->next) {
+		if (*prev == timer) {
+			*prev = timer->next;
+			timer->next = NULL;
+			return prev == &ctx->timers;
+		}
+	}
+
+	return 0;
+}
+
+/*******************************************************************************
+ * This function arms 'timer' to call 'handler' on this cpu once the physical
+ * counter has reached 'deadline'. A timer which is already armed is moved to
+ * the new deadline. The handler is called with FIQs masked and may arm the
+ * timer again. The secure physical timer is only reprogrammed if the first
+ * deadline of this cpu changes.
+ ******************************************************************************/
+void tsp_timer_arm(tsp_timer_t *timer,
+		   uint64_t deadline,
+		   void (*handler)(tsp_timer_t *timer))
+{
+	timer_context_t *ctx;
+	tsp_timer_t **prev;
+	uint32_t daif = read_daif();
+	int reprogram;
+
+	assert(handler);
+
+	/* Keep the timer FIQ from changing the list under our feet */
+	disable_fiq();
+	ctx = &pcpu_timer_context[platform_get_core_pos(read_mpidr())];
+
+	reprogram = tsp_timer_unlink(ctx, timer);
+
+	timer->deadline = deadline;
+	timer->handler = handler;
+	for (prev = &ctx->timers; *prev; prev = &(*prev)->next) {
+		if ((*prev)->deadline > deadline)
+			break;
+	}
+	timer->next = *prev;
+	*prev = timer;
+
+	if (reprogram || ctx->timers == timer)
+		tsp_generic_timer_program(ctx);
+
+	write_daif(daif);
+}
+
+/*******************************************************************************
+ * This function disarms 'timer' on this cpu if it is armed
+ ******************************************************************************/
+void tsp_timer_cancel(tsp_timer_t *timer)
+{
+	timer_context_t *ctx;
+	uint32_t daif = read_daif();
+
+	disable_fiq();
+	ctx = &pcpu_timer_context[platform_get_core_pos(read_mpidr())];
+
+	if (tsp_timer_unlink(ctx, timer))
+		tsp_generic_timer_program(ctx);
+
+	write_daif(daif);
+}
+
+/*******************************************************************************
+ * This function initializes the list of software timers of this cpu. Unless
+ * the TSP is built tickless, it arms a timer to fire every 0.5 second.
+ ******************************************************************************/
+void tsp_generic_timer_start(void)
+{
+	uint32_t linear_id = platform_get_core_pos(read_mpidr());
+
+	/* The timers armed before this cpu was turned off are forgotten */
+	pcpu_timer_context[linear_id].timers = NULL;
+	write_cntps_ctl_el1(0);
+
+#if !TSP_TIMER_TICKLESS
+	tsp_timer_arm(&pcpu_tick_timer[linear_id],
+		      read_cntpct_el0() + (read_cntfrq_el0() >> 1),
+		      tsp_tick_timer_handler);
+#endif
+}
+
+/*******************************************************************************
+ * This function deasserts the timer interrupt, runs the software timers which
+ * have expired and sets up the timer again for the next deadline, if any
  ******************************************************************************/
 void tsp_generic_timer_handler(void)
 {
+	uint32_t linear_id = platform_get_core_pos(read_mpidr());
+	timer_context_t *ctx = &pcpu_timer_context[linear_id];
+	tsp_timer_t *timer;
+	uint64_t now, late;
+#if LOG_LEVEL >= LOG_LEVEL_VERBOSE
+	uint64_t late_max = ctx->late_max;
+#endif
+
 	/* Ensure that the timer did assert the interrupt */
 	assert(get_cntp_ctl_istatus(read_cntps_ctl_el1()));
 
@@ -74,8 +210,32 @@ void tsp_generic_timer_handler(void)
 	 */
 	isb();
 	write_cntps_ctl_el1(0);
-	tsp_generic_timer_start();
+
+	now = read_cntpct_el0();
+	while ((timer = ctx->timers) && timer->deadline <= now) {
+		ctx->timers = timer->next;
+		timer->next = NULL;
+
+		late = now - timer->deadline;
+		ctx->fire_count++;
+		if (late > ctx->late_max)
+			ctx->late_max = late;
+
+		timer->handler(timer);
+	}
+
+	tsp_generic_timer_program(ctx);
 	isb();
+
+#if LOG_LEVEL >= LOG_LEVEL_VERBOSE
+	/* Keep the console out of the common path by reporting new maxima only */
+	if (ctx->late_max != late_max) {
+		spin_lock(&console_lock);
+		VERBOSE("TSP: cpu 0x%x: %d timers run, %lld ticks late at most\n",
+			read_mpidr(), ctx->fire_count, ctx->late_max);
+		spin_unlock(&console_lock);
+	}
+#endif
 }
 
 /*******************************************************************************
@@ -38,7 +38,9 @@
 #include <gic_v3.h>
 #include <interrupt_mgmt.h>
 #include <platform.h>
+#include <platform_def.h>
 #include <stdint.h>
+#include <sys/cdefs.h>
 
 /* Value used to initialize Non-Secure IRQ priorities four at a time */
 #define GICD_IPRIORITYR_DEF_VAL \
@@ -53,6 +55,55 @@ static unsigned long g_gicr_base;
 static const unsigned int *g_irq_sec_ptr;
 static unsigned int g_num_irqs;
 
+/*
+ * Bitmap of the secure interrupts which have been configured as EL3 interrupts
+ * through arm_gic_set_interrupt_type(). All other secure interrupts are
+ * treated as S-EL1 interrupts.
+ */
+#define MAX_INTR_IDS		1020
+static uint32_t g_el3_irq_map[(MAX_INTR_IDS + 31) >> 5];
+
+#define is_el3_interrupt(id)	((g_el3_irq_map[(id) >> 5] >> ((id) & 0x1f)) \
+				 & 1)
+
+/*
+ * Base address of the redistributor frame of each cpu. It is resolved once at
+ * cold boot so that the frames need not be walked on every cpu power up.
+ */
+static uintptr_t g_rdist_base[PLATFORM_CORE_COUNT];
+
+#if ARM_GIC_ARCH == 2
+/*
+ * Cpu interface mask of each cpu as read from its banked GICD_ITARGETSR0. It
+ * is recorded by each cpu when it first configures its SGIs and PPIs so that
+ * SGIs can be targeted at it from other cpus. This may happen with the data
+ * cache disabled, so each entry is placed in its own cache line so that the
+ * write back of a neighbouring entry cannot overwrite it.
+ */
+typedef struct cpuif_id {
+	uint8_t mask;
+} __aligned(CACHE_WRITEBACK_GRANULE) cpuif_id_t;
+
+static cpuif_id_t g_cpuif_id[PLATFORM_CORE_COUNT];
+#endif
+
+/*******************************************************************************
+ * Return the base address of the redistributor frame of the calling cpu, or
+ * NULL if no frame was found for it at cold boot.
+ ******************************************************************************/
+static uintptr_t arm_gic_get_rdist(void)
+{
+	uintptr_t base;
+
+	assert(g_gicr_base);
+	base = g_rdist_base[platform_get_core_pos(read_mpidr())];
+	if (base == (uintptr_t)NULL)
+		ERROR("GICv3 - Did not find RDIST for CPU with MPIDR 0x%lx\n",
+		      read_mpidr());
+
+	return base;
+}
+
 
 /*******************************************************************************
  * This function does some minimal GICv3 configuration. The Firmware itself does
@@ -73,8 +124,7 @@ static void gicv3_cpuif_setup(void)
 	 * GICR_WAKER is NOT banked per CPU, compute the correct base address
 	 * per CPU.
 	 */
-	assert(g_gicr_base);
-	base = gicv3_get_rdist(g_gicr_base, read_mpidr());
+	base = arm_gic_get_rdist();
 	if (base == (uintptr_t)NULL) {
 		/* No re-distributor base address. This interface cannot be
 		 * configured.
@@ -140,8 +190,7 @@ static void gicv3_cpuif_deactivate(void)
 	 * GICR_WAKER is NOT banked per CPU, compute the correct base address
 	 * per CPU.
 	 */
-	assert(g_gicr_base);
-	base = gicv3_get_rdist(g_gicr_base, read_mpidr());
+	base = arm_gic_get_rdist();
 	if (base == (uintptr_t)NULL) {
 		/* No re-distributor base address. This interface cannot be
 		 * configured.
@@ -169,6 +218,21 @@ void arm_gic_cpuif_setup(void)
 {
 	unsigned int val;
 
+#if ARM_GIC_ARCH == 3
+	gicv3_cpuif_setup();
+
+	/*
+	 * Enable the system register interface for S-EL1 so that the Secure
+	 * Payload can also use it to handle its interrupts.
+	 */
+	val = read_icc_sre_el1();
+	write_icc_sre_el1(val | ICC_SRE_SRE);
+	isb();
+
+	/* Enable group0 interrupts. These are always signalled as FIQs. */
+	write_icc_igrpen0_el1(ICC_IGRPEN_EN);
+	isb();
+#else
 	assert(g_gicc_base);
 	val = gicc_read_iidr(g_gicc_base);
 
@@ -185,6 +249,7 @@ void arm_gic_cpuif_setup(void)
 
 	gicc_write_pmr(g_gicc_base, GIC_PRI_MASK);
 	gicc_write_ctlr(g_gicc_base, val);
+#endif /* ARM_GIC_ARCH */
 }
 
 /*******************************************************************************
@@ -193,6 +258,13 @@ void arm_gic_cpuif_setup(void)
  ******************************************************************************/
 void arm_gic_cpuif_deactivate(void)
 {
+#if ARM_GIC_ARCH == 3
+	/* Disable group0 interrupts and put the redistributor to sleep */
+	write_icc_igrpen0_el1(0);
+	isb();
+
+	gicv3_cpuif_deactivate();
+#else
 	unsigned int val;
 
 	/* Disable secure, non-secure interrupts and disable their bypass */
@@ -211,24 +283,48 @@ void arm_gic_cpuif_deactivate(void)
 	 */
 	if (((val >> GICC_IIDR_ARCH_SHIFT) & GICC_IIDR_ARCH_MASK) >= 3)
 		gicv3_cpuif_deactivate();
+#endif /* ARM_GIC_ARCH */
 }
 
 /*******************************************************************************
  * Per cpu gic distributor setup which will be done by all cpus after a cold
  * boot/hotplug. This marks out the secure interrupts & enables them.
  ******************************************************************************/
+#if ARM_GIC_ARCH == 3
+/*******************************************************************************
+ * Return the base address of the SGI & PPI frame of the redistributor of the
+ * calling cpu.
+ ******************************************************************************/
+static uintptr_t arm_gic_get_rdist_sgi_base(void)
+{
+	uintptr_t base;
+
+	base = arm_gic_get_rdist();
+	if (base == (uintptr_t)NULL)
+		panic();
+
+	return base + GICR_SGIBASE_OFFSET;
+}
+
+/*******************************************************************************
+ * Per cpu gic redistributor setup which will be done by all cpus after a cold
+ * boot/hotplug. With affinity routing enabled, the SGIs and PPIs are
+ * configured through the redistributor instead of the distributor. This marks
+ * out the secure interrupts & enables them.
+ ******************************************************************************/
 void arm_gic_pcpu_distif_setup(void)
 {
 	unsigned int index, irq_num;
+	uintptr_t sgi_base;
 
-	assert(g_gicd_base);
+	sgi_base = arm_gic_get_rdist_sgi_base();
 
 	/* Mark all 32 SGI+PPI interrupts as Group 1 (non-secure) */
-	gicd_write_igroupr(g_gicd_base, 0, ~0);
+	gicr_write_igroupr0(sgi_base, ~0);
 
 	/* Setup PPI priorities doing four at a time */
-	for (index = 0; index < 32; index += 4) {
-		gicd_write_ipriorityr(g_gicd_base, index,
+	for (index = 0; index < MIN_SPI_ID; index += 4) {
+		gicr_write_ipriorityr(sgi_base, index,
 				GICD_IPRIORITYR_DEF_VAL);
 	}
 
@@ -237,14 +333,86 @@ void arm_gic_pcpu_distif_setup(void)
 		irq_num = g_irq_sec_ptr[index];
 		if (irq_num < MIN_SPI_ID) {
 			/* We have an SGI or a PPI */
+			gicr_write_igroupr0(sgi_base,
+				gicr_read_igroupr0(sgi_base) & ~(1 << irq_num));
+			gicr_set_ipriorityr(sgi_base, irq_num,
+				GIC_HIGHEST_SEC_PRIORITY);
+			gicr_write_isenabler0(sgi_base, 1 << irq_num);
+		}
+	}
+}
+
+/*******************************************************************************
+ * Wait for a write to the GICD_CTLR to take effect.
+ ******************************************************************************/
+static void gicd_wait_for_pending_write(void)
+{
+	while (gicd_read_ctlr(g_gicd_base) & GICD_CTLR_RWP)
+		;
+}
+
+/*******************************************************************************
+ * Global gic distributor setup which will be done by the primary cpu after a
+ * cold boot. It enables affinity routing for both security states, marks out
+ * the secure SPIs and routes them to the primary cpu. It then configures the
+ * SGIs and PPIs of the primary cpu and enables the group0 and non-secure
+ * group1 interrupts.
+ ******************************************************************************/
+static void arm_gic_distif_setup(void)
+{
+	unsigned int num_ints, ctlr, index, irq_num;
+	uint64_t affinity;
+
+	/* Disable the distributor before going further */
+	assert(g_gicd_base);
+	ctlr = gicd_read_ctlr(g_gicd_base);
+	ctlr &= ~(ENABLE_GRP0 | ENABLE_GRP1);
+	gicd_write_ctlr(g_gicd_base, ctlr);
+	gicd_wait_for_pending_write();
+
+	ctlr |= GICD_CTLR_ARE_S | GICD_CTLR_ARE_NS;
+	gicd_write_ctlr(g_gicd_base, ctlr);
+	gicd_wait_for_pending_write();
+
+	/*
+	 * Mark out non-secure SPI interrupts. The number of interrupts is
+	 * calculated as 32 * (IT_LINES + 1). We do 32 at a time.
+	 */
+	num_ints = gicd_read_typer(g_gicd_base) & IT_LINES_NO_MASK;
+	num_ints = (num_ints + 1) << 5;
+	for (index = MIN_SPI_ID; index < num_ints; index += 32)
+		gicd_write_igroupr(g_gicd_base, index, ~0);
+
+	/* Setup SPI priorities doing four at a time */
+	for (index = MIN_SPI_ID; index < num_ints; index += 4) {
+		gicd_write_ipriorityr(g_gicd_base, index,
+				GICD_IPRIORITYR_DEF_VAL);
+	}
+
+	/* Route the secure SPIs to this cpu */
+	affinity = read_mpidr() & MPIDR_AFFINITY_MASK;
+
+	/* Configure SPI secure interrupts now */
+	assert(g_irq_sec_ptr);
+	for (index = 0; index < g_num_irqs; index++) {
+		irq_num = g_irq_sec_ptr[index];
+		if (irq_num >= MIN_SPI_ID) {
+			/* We have an SPI */
 			gicd_clr_igroupr(g_gicd_base, irq_num);
 			gicd_set_ipriorityr(g_gicd_base, irq_num,
 				GIC_HIGHEST_SEC_PRIORITY);
+			gicd_write_irouter(g_gicd_base, irq_num, affinity);
 			gicd_set_isenabler(g_gicd_base, irq_num);
 		}
 	}
-}
 
+	/* Configure the SGI and PPI of this cpu in its redistributor */
+	arm_gic_pcpu_distif_setup();
+
+	gicd_write_ctlr(g_gicd_base, ctlr | ENABLE_GRP0 | ENABLE_GRP1);
+	gicd_wait_for_pending_write();
+}
+#else
 /*******************************************************************************
  * Get the current CPU bit mask from GICD_ITARGETSR0
  ******************************************************************************/
@@ -256,6 +424,45 @@ static unsigned int arm_gic_get_cpuif_id(void)
 	return val & GIC_TARGET_CPU_MASK;
 }
 
+void arm_gic_pcpu_distif_setup(void)
+{
+	unsigned int index, irq_num, core_pos;
+
+	assert(g_gicd_base);
+
+	/*
+	 * Record the cpu interface of this cpu. This may be called with the
+	 * data cache disabled, so ensure that the value reaches main memory.
+	 */
+	core_pos = platform_get_core_pos(read_mpidr());
+	flush_dcache_range((uint64_t) &g_cpuif_id[core_pos],
+			   sizeof(g_cpuif_id[core_pos]));
+	g_cpuif_id[core_pos].mask = arm_gic_get_cpuif_id();
+	flush_dcache_range((uint64_t) &g_cpuif_id[core_pos],
+			   sizeof(g_cpuif_id[core_pos]));
+
+	/* Mark all 32 SGI+PPI interrupts as Group 1 (non-secure) */
+	gicd_write_igroupr(g_gicd_base, 0, ~0);
+
+	/* Setup PPI priorities doing four at a time */
+	for (index = 0; index < 32; index += 4) {
+		gicd_write_ipriorityr(g_gicd_base, index,
+				GICD_IPRIORITYR_DEF_VAL);
+	}
+
+	assert(g_irq_sec_ptr);
+	for (index = 0; index < g_num_irqs; index++) {
+		irq_num = g_irq_sec_ptr[index];
+		if (irq_num < MIN_SPI_ID) {
+			/* We have an SGI or a PPI */
+			gicd_clr_igroupr(g_gicd_base, irq_num);
+			gicd_set_ipriorityr(g_gicd_base, irq_num,
+				GIC_HIGHEST_SEC_PRIORITY);
+			gicd_set_isenabler(g_gicd_base, irq_num);
+		}
+	}
+}
+
 /*******************************************************************************
  * Global gic distributor setup which will be done by the primary cpu after a
  * cold boot. It marks out the secure SPIs, PPIs & SGIs and enables them. It
@@ -313,6 +520,7 @@ static void arm_gic_distif_setup(void)
 
 	gicd_write_ctlr(g_gicd_base, ctlr | ENABLE_GRP0);
 }
+#endif /* ARM_GIC_ARCH */
 
 /*******************************************************************************
  * Initialize the ARM GIC driver with the provided platform inputs
@@ -324,21 +532,34 @@ void arm_gic_init(unsigned int gicc_base,
 		unsigned int num_irqs
 		)
 {
+#if ARM_GIC_ARCH == 2
 	unsigned int val;
+#endif
 
-	assert(gicc_base);
 	assert(gicd_base);
 	assert(irq_sec_ptr);
 
 	g_gicc_base = gicc_base;
 	g_gicd_base = gicd_base;
 
+#if ARM_GIC_ARCH == 3
+	/* The memory mapped cpu interface is not used */
+	assert(gicr_base);
+	g_gicr_base = gicr_base;
+	gicv3_populate_rdist_base(g_gicr_base, g_rdist_base,
+				  PLATFORM_CORE_COUNT, platform_get_core_pos);
+#else
+	assert(gicc_base);
 	val = gicc_read_iidr(g_gicc_base);
 
 	if (((val >> GICC_IIDR_ARCH_SHIFT) & GICC_IIDR_ARCH_MASK) >= 3) {
 		assert(gicr_base);
 		g_gicr_base = gicr_base;
+		gicv3_populate_rdist_base(g_gicr_base, g_rdist_base,
+					  PLATFORM_CORE_COUNT,
+					  platform_get_core_pos);
 	}
+#endif
 
 	g_irq_sec_ptr = irq_sec_ptr;
 	g_num_irqs = num_irqs;
@@ -372,13 +593,22 @@ uint32_t arm_gic_interrupt_type_to_line(uint32_t type,
 
 	assert(sec_state_is_valid(security_state));
 
+#if ARM_GIC_ARCH == 2
 	/*
 	 * We ignore the security state parameter under the assumption that
-	 * both normal and secure worlds are using ARM GICv2. This parameter
-	 * will be used when the secure world starts using GICv3.
+	 * both normal and secure worlds are using ARM GICv2.
 	 */
-#if ARM_GIC_ARCH == 2
 	return gicv2_interrupt_type_to_line(g_gicc_base, type);
+#elif ARM_GIC_ARCH == 3
+	/*
+	 * Group0 interrupts are always signalled as FIQs. Non-secure group1
+	 * interrupts are signalled as IRQs while executing in the non-secure
+	 * state and as FIQs while executing in the secure state.
+	 */
+	if (type != INTR_TYPE_NS || security_state == SECURE)
+		return __builtin_ctz(SCR_FIQ_BIT);
+
+	return __builtin_ctz(SCR_IRQ_BIT);
 #else
 #error "Invalid ARM GIC architecture version specified for platform port"
 #endif /* ARM_GIC_ARCH */
@@ -397,7 +627,10 @@ uint32_t arm_gic_get_pending_interrupt_type(void)
 	assert(g_gicc_base);
 	id = gicc_read_hppir(g_gicc_base);
 
-	/* Assume that all secure interrupts are S-EL1 interrupts */
+	if (id < MAX_INTR_IDS)
+		return is_el3_interrupt(id) ? INTR_TYPE_EL3 : INTR_TYPE_S_EL1;
+
+	/* Ids 1020 and 1021 are reserved and not used by GICv2 */
 	if (id < 1022)
 		return INTR_TYPE_S_EL1;
 
@@ -442,6 +675,21 @@ uint32_t arm_gic_acknowledge_interrupt(void)
 	return gicc_read_IAR(g_gicc_base);
 }
 
+/*******************************************************************************
+ * This function returns the id of the interrupt acknowledged with the IAR
+ * contents 'iar'. INTR_ID_UNAVAILABLE is returned for a spurious interrupt.
+ ******************************************************************************/
+uint32_t arm_gic_get_interrupt_id(uint32_t iar)
+{
+	uint32_t id = iar & GICC_IAR_INTID_MASK;
+
+	/* Ids 1020 to 1023 are reserved for special purposes */
+	if (id >= 1020)
+		return INTR_ID_UNAVAILABLE;
+
+	return id;
+}
+
 /*******************************************************************************
  * This functions writes the GIC cpu interface End Of Interrupt register with
  * the passed value to finish handling the active interrupt
@@ -464,11 +712,205 @@ uint32_t arm_gic_get_interrupt_type(uint32_t id)
 	assert(g_gicd_base);
 	group = gicd_get_igroupr(g_gicd_base, id);
 
-	/* Assume that all secure interrupts are S-EL1 interrupts */
-	if (group == GRP0)
-		return INTR_TYPE_S_EL1;
+	if (group == GRP1)
+		return INTR_TYPE_NS;
+
+	if (id < MAX_INTR_IDS && is_el3_interrupt(id))
+		return INTR_TYPE_EL3;
+
+	return INTR_TYPE_S_EL1;
+}
+
+/*******************************************************************************
+ * This function sets the type of the secure interrupt 'id' to be either an EL3
+ * or a S-EL1 interrupt. Both types are configured as group0 interrupts in the
+ * GIC, so the type is only tracked in the driver to be reported by the
+ * functions above.
+ ******************************************************************************/
+void arm_gic_set_interrupt_type(uint32_t id, uint32_t type)
+{
+	assert(id < MAX_INTR_IDS);
+	assert(type == INTR_TYPE_EL3 || type == INTR_TYPE_S_EL1);
+	assert(g_gicd_base);
+	assert(gicd_get_igroupr(g_gicd_base, id) == GRP0);
+
+	if (type == INTR_TYPE_EL3)
+		g_el3_irq_map[id >> 5] |= 1U << (id & 0x1f);
 	else
+		g_el3_irq_map[id >> 5] &= ~(1U << (id & 0x1f));
+}
+
+/*******************************************************************************
+ * This function raises the secure SGI 'id' on the cpu with the mpidr 'target'
+ * through the distributor. The cpu interface of the target is the one it
+ * recorded when it configured its SGIs and PPIs.
+ ******************************************************************************/
+void arm_gic_raise_sgi(uint32_t id, uint64_t target)
+{
+	unsigned int core_pos = platform_get_core_pos(target);
+
+	assert(g_gicd_base);
+	assert(id < MIN_PPI_ID);
+	assert(core_pos < PLATFORM_CORE_COUNT);
+	assert(g_cpuif_id[core_pos].mask);
+
+	/* Ensure that prior memory accesses are visible to the target */
+	dsb();
+	gicd_write_sgir(g_gicd_base,
+			(g_cpuif_id[core_pos].mask << SGIR_TGT_LIST_SHIFT) |
+			(id & SGIR_INTID_MASK));
+}
+
+#elif ARM_GIC_ARCH == 3
+/*******************************************************************************
+ * This function returns the type of the highest priority pending interrupt at
+ * the GIC cpu interface. It is read from the group0 system register view which
+ * reports special ids for pending group1 interrupts. INTR_TYPE_INVAL is
+ * returned when there is no interrupt pending.
+ ******************************************************************************/
+uint32_t arm_gic_get_pending_interrupt_type(void)
+{
+	uint32_t id;
+
+	id = read_icc_hppir0_el1() & ICC_INTID_MASK;
+
+	if (id < MAX_INTR_IDS)
+		return is_el3_interrupt(id) ? INTR_TYPE_EL3 : INTR_TYPE_S_EL1;
+
+	if (id == ICC_PENDING_G1S_INTID)
+		return INTR_TYPE_S_EL1;
+
+	if (id == ICC_PENDING_G1NS_INTID)
 		return INTR_TYPE_NS;
+
+	return INTR_TYPE_INVAL;
+}
+
+/*******************************************************************************
+ * This function returns the id of the highest priority pending interrupt at
+ * the GIC cpu interface. INTR_ID_UNAVAILABLE is returned when there is no
+ * interrupt pending.
+ ******************************************************************************/
+uint32_t arm_gic_get_pending_interrupt_id(void)
+{
+	uint32_t id;
+
+	id = read_icc_hppir0_el1() & ICC_INTID_MASK;
+
+	if (id < MAX_INTR_IDS)
+		return id;
+
+	if (id == GIC_SPURIOUS_INTERRUPT)
+		return INTR_ID_UNAVAILABLE;
+
+	/* Find out which group1 interrupt it is */
+	return read_icc_hppir1_el1() & ICC_INTID_MASK;
+}
+
+/*******************************************************************************
+ * This functions reads the group0 Interrupt Acknowledge system register to
+ * start handling the pending interrupt. It returns the contents of the IAR.
+ ******************************************************************************/
+uint32_t arm_gic_acknowledge_interrupt(void)
+{
+	return read_icc_iar0_el1();
+}
+
+/*******************************************************************************
+ * This function returns the id of the interrupt acknowledged with the IAR
+ * contents 'iar'. INTR_ID_UNAVAILABLE is returned for a spurious interrupt.
+ ******************************************************************************/
+uint32_t arm_gic_get_interrupt_id(uint32_t iar)
+{
+	uint32_t id = iar & ICC_INTID_MASK;
+
+	/* Ids 1020 to 1023 are reserved for special purposes */
+	if (id >= 1020 && id <= GIC_SPURIOUS_INTERRUPT)
+		return INTR_ID_UNAVAILABLE;
+
+	return id;
+}
+
+/*******************************************************************************
+ * This functions writes the group0 End Of Interrupt system register with the
+ * passed value to finish handling the active interrupt
+ ******************************************************************************/
+void arm_gic_end_of_interrupt(uint32_t id)
+{
+	write_icc_eoir0_el1(id);
+}
+
+/*******************************************************************************
+ * This function returns the type of the interrupt id depending upon the group
+ * this interrupt has been configured under by the interrupt controller i.e.
+ * group0 or group1. SGIs and PPIs are looked up in the redistributor of the
+ * calling cpu.
+ ******************************************************************************/
+uint32_t arm_gic_get_interrupt_type(uint32_t id)
+{
+	uint32_t group;
+
+	if (id < MIN_SPI_ID) {
+		group = (gicr_read_igroupr0(arm_gic_get_rdist_sgi_base())
+			 >> id) & 1;
+	} else {
+		assert(g_gicd_base);
+		group = gicd_get_igroupr(g_gicd_base, id);
+	}
+
+	if (group == GRP1)
+		return INTR_TYPE_NS;
+
+	if (id < MAX_INTR_IDS && is_el3_interrupt(id))
+		return INTR_TYPE_EL3;
+
+	return INTR_TYPE_S_EL1;
+}
+
+/*******************************************************************************
+ * This function sets the type of the secure interrupt 'id' to be either an EL3
+ * or a S-EL1 interrupt. Both types are configured as group0 interrupts in the
+ * GIC, so the type is only tracked in the driver to be reported by the
+ * functions above.
+ ******************************************************************************/
+void arm_gic_set_interrupt_type(uint32_t id, uint32_t type)
+{
+	assert(id < MAX_INTR_IDS);
+	assert(type == INTR_TYPE_EL3 || type == INTR_TYPE_S_EL1);
+	assert(arm_gic_get_interrupt_type(id) != INTR_TYPE_NS);
+
+	if (type == INTR_TYPE_EL3)
+		g_el3_irq_map[id >> 5] |= 1U << (id & 0x1f);
+	else
+		g_el3_irq_map[id >> 5] &= ~(1U << (id & 0x1f));
+}
+
+/*******************************************************************************
+ * This function raises the secure SGI 'id' on the cpu with the mpidr 'target'
+ * by writing the group0 SGI generation system register. The target is
+ * specified by its affinity fields.
+ ******************************************************************************/
+void arm_gic_raise_sgi(uint32_t id, uint64_t target)
+{
+	uint64_t aff0, sgir;
+
+	assert(id < MIN_PPI_ID);
+
+	aff0 = (target >> MPIDR_AFF0_SHIFT) & MPIDR_AFFLVL_MASK;
+	sgir = 1 << (aff0 & ICC_SGIR_TGT_AFF0_MASK);
+	sgir |= (aff0 >> ICC_SGIR_RS_AFF0_SHIFT) << ICC_SGIR_RS_SHIFT;
+	sgir |= ((target >> MPIDR_AFF1_SHIFT) & MPIDR_AFFLVL_MASK)
+		<< ICC_SGIR_AFF1_SHIFT;
+	sgir |= ((target >> MPIDR_AFF2_SHIFT) & MPIDR_AFFLVL_MASK)
+		<< ICC_SGIR_AFF2_SHIFT;
+	sgir |= ((target >> MPIDR_AFF3_SHIFT) & MPIDR_AFFLVL_MASK)
+		<< ICC_SGIR_AFF3_SHIFT;
+	sgir |= (uint64_t) id << ICC_SGIR_INTID_SHIFT;
+
+	/* Ensure that prior memory accesses are visible to the target */
+	dsb();
+	write_icc_sgi0r_el1(sgir);
+	isb();
 }
 
 #else
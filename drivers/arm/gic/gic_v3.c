@@ -29,42 +29,45 @@
  */
 
 #include <arch.h>
-#include <debug.h>
 #include <gic_v3.h>
 
-uintptr_t gicv3_get_rdist(uintptr_t gicr_base, uint64_t mpidr)
+/*******************************************************************************
+ * Walk all the redistributor frames starting from 'gicr_base' and record the
+ * base address of the frame of each cpu in 'rdist_base', indexed by the linear
+ * core position that 'core_pos' returns for the MPIDR of the cpu. Frames of
+ * cpus whose core position is beyond 'num' entries are ignored. This allows
+ * the frames to be looked up in constant time instead of being walked on every
+ * cpu power up.
+ ******************************************************************************/
+void gicv3_populate_rdist_base(uintptr_t gicr_base,
+			       uintptr_t *rdist_base,
+			       unsigned int num,
+			       unsigned int (*core_pos)(unsigned long mpidr))
 {
-	uint32_t  cpu_aff, gicr_aff;
-	uint64_t  gicr_typer;
+	uint32_t  gicr_aff;
+	uint64_t  gicr_typer, mpidr;
 	uintptr_t addr;
-
-	/* Construct the affinity as used by GICv3. MPIDR and GIC affinity level
-	 * mask is the same.
-	 */
-	cpu_aff  = ((mpidr >> MPIDR_AFF0_SHIFT) & MPIDR_AFFLVL_MASK) <<
-			GICV3_AFF0_SHIFT;
-	cpu_aff |= ((mpidr >> MPIDR_AFF1_SHIFT) & MPIDR_AFFLVL_MASK) <<
-			GICV3_AFF1_SHIFT;
-	cpu_aff |= ((mpidr >> MPIDR_AFF2_SHIFT) & MPIDR_AFFLVL_MASK) <<
-			GICV3_AFF2_SHIFT;
-	cpu_aff |= ((mpidr >> MPIDR_AFF3_SHIFT) & MPIDR_AFFLVL_MASK) <<
-			GICV3_AFF3_SHIFT;
+	unsigned int idx;
 
 	addr = gicr_base;
 	do {
 		gicr_typer = gicr_read_typer(addr);
 
+		/* Construct the MPIDR from the affinity used by GICv3 */
 		gicr_aff = (gicr_typer >> GICR_TYPER_AFF_SHIFT) &
 				GICR_TYPER_AFF_MASK;
-		if (cpu_aff == gicr_aff) {
-			/* Disable this print for now as it appears every time
-			 * when using PSCI CPU_SUSPEND.
-			 * TODO: Print this only the first time for each CPU.
-			 * INFO("GICv3 - Found RDIST for MPIDR(0x%lx) at 0x%lx\n",
-			 *	mpidr, addr);
-			 */
-			return addr;
-		}
+		mpidr  = (uint64_t)((gicr_aff >> GICV3_AFF0_SHIFT) &
+				MPIDR_AFFLVL_MASK) << MPIDR_AFF0_SHIFT;
+		mpidr |= (uint64_t)((gicr_aff >> GICV3_AFF1_SHIFT) &
+				MPIDR_AFFLVL_MASK) << MPIDR_AFF1_SHIFT;
+		mpidr |= (uint64_t)((gicr_aff >> GICV3_AFF2_SHIFT) &
+				MPIDR_AFFLVL_MASK) << MPIDR_AFF2_SHIFT;
+		mpidr |= (uint64_t)((gicr_aff >> GICV3_AFF3_SHIFT) &
+				MPIDR_AFFLVL_MASK) << MPIDR_AFF3_SHIFT;
+
+		idx = core_pos(mpidr);
+		if (idx < num)
+			rdist_base[idx] = addr;
 
 		/* TODO:
 		 * For GICv4 we need to adjust the Base address based on
@@ -73,8 +76,4 @@ uintptr_t gicv3_get_rdist(uintptr_t gicr_base, uint64_t mpidr)
 		addr += (1 << GICR_PCPUBASE_SHIFT);
 
 	} while (!(gicr_typer & GICR_TYPER_LAST));
-
-	/* If we get here we did not find a match. */
-	ERROR("GICv3 - Did not find RDIST for CPU with MPIDR 0x%lx\n", mpidr);
-	return (uintptr_t)NULL;
 }
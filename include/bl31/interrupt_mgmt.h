@@ -63,6 +63,10 @@
 #define INTR_NS_VALID_RM0		0x0
 /* Routed to EL1/EL2 from NS and to EL3 from Secure */
 #define INTR_NS_VALID_RM1		0x1
+/* Routed to EL3 from NS. Taken to S-EL1 from Secure */
+#define INTR_EL3_VALID_RM0		0x2
+/* Routed to EL3 from NS and Secure */
+#define INTR_EL3_VALID_RM1		0x3
 /* This is the default routing model */
 #define INTR_DEFAULT_RM		0x0
 
@@ -95,6 +99,33 @@
 					 (x == INTR_NS_VALID_RM1 ? 0 :\
 					  -EINVAL))
 
+#define validate_el3_interrupt_rm(x)	(x == INTR_EL3_VALID_RM0 ? 0 : \
+					 (x == INTR_EL3_VALID_RM1 ? 0 :\
+					  -EINVAL))
+
+/*******************************************************************************
+ * Maximum number of interrupt ids for which a handler can be registered with
+ * the framework for handling in EL3
+ ******************************************************************************/
+#define MAX_EL3_INTR_HANDLERS		8
+
+/*******************************************************************************
+ * Interrupt ids at or above this value are not valid interrupt sources and
+ * cannot be registered with the framework for handling in EL3
+ ******************************************************************************/
+#define MAX_INTR_IDS			1020
+
+/*******************************************************************************
+ * Constants for the interrupt latency histograms maintained for each cpu when
+ * INTR_LATENCY_STATS is set. Each bucket 'n' counts the latencies which were
+ * in the range [2^n, 2^(n+1)) system counter ticks. The last bucket also counts
+ * all larger latencies.
+ ******************************************************************************/
+#define INTR_LAT_ENTRY_TO_HANDOFF	0
+#define INTR_LAT_HANDOFF_TO_RETURN	1
+#define INTR_LAT_NUM_HISTS		2
+#define INTR_LAT_NUM_BUCKETS		16
+
 /*******************************************************************************
  * Macros to set the 'flags' parameter passed to an interrupt type handler. Only
  * the flag to indicate the security state when the exception was generated is
@@ -109,6 +140,8 @@
 
 #ifndef __ASSEMBLY__
 
+#include <stdint.h>
+
 /* Prototype for defining a handler for an interrupt type */
 typedef uint64_t (*interrupt_type_handler_t)(uint32_t id,
 					     uint32_t flags,
@@ -124,8 +157,23 @@ int32_t register_interrupt_type_handler(uint32_t type,
 					interrupt_type_handler_t handler,
 					uint32_t flags);
 interrupt_type_handler_t get_interrupt_type_handler(uint32_t interrupt_type);
+int32_t register_interrupt_handler(uint32_t id,
+				   interrupt_type_handler_t handler,
+				   uint32_t flags);
+interrupt_type_handler_t get_interrupt_handler(uint32_t id);
 int disable_intr_rm_local(uint32_t type, uint32_t security_state);
 int enable_intr_rm_local(uint32_t type, uint32_t security_state);
 
+#if INTR_LATENCY_STATS
+void intr_lat_stats_mark_entry(void);
+void intr_lat_stats_mark_handoff(void);
+void intr_lat_stats_mark_return(void);
+int32_t intr_lat_stats_get(uint64_t mpidr,
+			   uint32_t hist,
+			   uint32_t bucket,
+			   uint64_t *count,
+			   uint64_t *max);
+#endif
+
 #endif /*__ASSEMBLY__*/
 #endif /* __INTERRUPT_MGMT_H__ */
@@ -64,6 +64,11 @@
 #define PSCI_FEATURES			0x8400000A
 #define PSCI_SYSTEM_SUSPEND_AARCH32	0x8400000E
 #define PSCI_SYSTEM_SUSPEND_AARCH64	0xc400000E
+#define PSCI_SET_SUSPEND_MODE		0x8400000F
+#define PSCI_STAT_RESIDENCY_AARCH32	0x84000010
+#define PSCI_STAT_RESIDENCY_AARCH64	0xc4000010
+#define PSCI_STAT_COUNT_AARCH32		0x84000011
+#define PSCI_STAT_COUNT_AARCH64		0xc4000011
 
 /* Macro to help build the psci capabilities bitfield */
 #define define_psci_cap(x)		(1 << (x & 0x1f))
@@ -71,7 +76,11 @@
 /*
  * Number of PSCI calls (above) implemented
  */
-#define PSCI_NUM_CALLS			18
+#if ENABLE_PSCI_STAT
+#define PSCI_NUM_CALLS			23
+#else
+#define PSCI_NUM_CALLS			19
+#endif
 
 /*******************************************************************************
  * PSCI Migrate and friends
@@ -106,6 +115,12 @@
 			(((type) & PSTATE_TYPE_MASK) << PSTATE_TYPE_SHIFT) |\
 			(((afflvl) & PSTATE_AFF_LVL_MASK) << PSTATE_AFF_LVL_SHIFT)
 
+/*******************************************************************************
+ * PSCI_SET_SUSPEND_MODE 'mode' parameter specific defines
+ ******************************************************************************/
+#define PSCI_MODE_PLAT_COORD	0
+#define PSCI_MODE_OS_INIT	1
+
 /*******************************************************************************
  * PSCI CPU_FEATURES feature flag specific defines
  ******************************************************************************/
@@ -154,6 +169,13 @@
 
 #define PSCI_INVALID_DATA -1
 
+/*
+ * Per-cpu initialisation steps which are retained across the power down of a
+ * cpu and only need to be done on its first power on. They are tracked with
+ * psci_{get,set,clear}_pcpu_init_done().
+ */
+#define PSCI_PCPU_INIT_GIC_DISTIF	(1 << 0)
+
 #define get_phys_state(x)	(x != PSCI_STATE_ON ? \
 				 PSCI_STATE_OFF : PSCI_STATE_ON)
 
@@ -170,17 +192,34 @@
  * this information will not reside on a cache line shared with another cpu.
  ******************************************************************************/
 typedef struct psci_cpu_data {
+	uint32_t state;			/* PSCI state of the cpu */
 	uint32_t power_state;
 	uint32_t max_phys_off_afflvl;	/* Highest affinity level in physically
 					   powered off state */
-#if !USE_COHERENT_MEM
+	uint32_t pcpu_init_done;	/* Per-cpu initialisation retained
+					   across the power down of the cpu */
+#if !USE_COHERENT_MEM && !HW_ASSISTED_COHERENCY
 	bakery_info_t pcpu_bakery_info[PSCI_NUM_AFFS];
 #endif
 } psci_cpu_data_t;
 
+/*******************************************************************************
+ * Structure describing the cost of a power state which can be requested through
+ * CPU_SUSPEND. The latencies and the minimum residency are in microseconds. The
+ * minimum residency includes the entry and exit latencies and is the shortest
+ * time for which entering the state saves energy.
+ ******************************************************************************/
+typedef struct plat_idle_state {
+	unsigned int power_state;
+	unsigned int entry_latency;
+	unsigned int exit_latency;
+	unsigned int min_residency;
+} plat_idle_state_t;
+
 /*******************************************************************************
  * Structure populated by platform specific code to export routines which
- * perform common low level pm functions
+ * perform common low level pm functions. The optional 'idle_states' table lists
+ * the power states from the shallowest to the deepest one.
  ******************************************************************************/
 typedef struct plat_pm_ops {
 	void (*affinst_standby)(unsigned int power_state);
@@ -200,6 +239,8 @@ typedef struct plat_pm_ops {
 	int (*validate_power_state)(unsigned int power_state);
 	int (*validate_ns_entrypoint)(unsigned long ns_entrypoint);
 	unsigned int (*get_sys_suspend_power_state)(void);
+	const plat_idle_state_t *idle_states;
+	unsigned int num_idle_states;
 } plat_pm_ops_t;
 
 /*******************************************************************************
@@ -228,9 +269,15 @@ int psci_affinity_info(unsigned long, unsigned int);
 int psci_migrate(unsigned long);
 int psci_migrate_info_type(void);
 long psci_migrate_info_up_cpu(void);
+int psci_features(unsigned int);
 int psci_cpu_on(unsigned long,
 		unsigned long,
 		unsigned long);
+int psci_cpu_on_batch(unsigned long,
+		      unsigned long,
+		      unsigned long,
+		      unsigned long,
+		      unsigned long *);
 void __dead2 psci_power_down_wfi(void);
 void psci_aff_on_finish_entry(void);
 void psci_aff_suspend_finish_entry(void);
@@ -238,6 +285,9 @@ void psci_register_spd_pm_hook(const spd_pm_ops_t *);
 int psci_get_suspend_stateid_by_mpidr(unsigned long);
 int psci_get_suspend_stateid(void);
 int psci_get_suspend_afflvl(void);
+int psci_get_pcpu_init_done(uint32_t);
+void psci_set_pcpu_init_done(uint32_t);
+void psci_clear_pcpu_init_done(uint32_t);
 uint32_t psci_get_max_phys_off_afflvl(void);
 
 uint64_t psci_smc_handler(uint32_t smc_fid,
@@ -64,6 +64,21 @@
 #define TSP_MUL		0x2002
 #define TSP_DIV		0x2003
 #define TSP_HANDLE_FIQ_AND_RETURN	0x2004
+#define TSP_BENCH	0x2005
+
+/*
+ * Variants of the TSP_BENCH service, passed in x1. The null variant returns
+ * without doing anything, the FP one writes all the FP/SIMD registers and the
+ * cache one reads and writes the number of cache lines passed in x2, up to
+ * TSP_BENCH_MAX_LINES. The service returns 0 or SMC_UNK for an unsupported
+ * variant in x0, the system counter when the TSP started handling the call in
+ * x1, the system counter when it returned in x2, and the counter ticks spent
+ * in the variant in x3.
+ */
+#define TSP_BENCH_NULL		0x0
+#define TSP_BENCH_FP		0x1
+#define TSP_BENCH_CACHE		0x2
+#define TSP_BENCH_MAX_LINES	16
 
 /*
  * Generate function IDs for TSP services to be used in SMC calls, by
@@ -75,6 +90,21 @@
 /* SMC function ID to request a previously preempted std smc */
 #define TSP_FID_RESUME		TSP_STD_FID(0x3000)
 
+/*
+ * SMC function ID to read the statistics kept by the TSPD for the cpu whose
+ * MPIDR is passed in x1, when it is built with TSPD_STATS=1. The group of
+ * statistics passed in x2 is returned in x1-x3, with 0 in x0:
+ * TSP_STATS_SMC:     fresh standard SMCs, fast SMCs, resumed standard SMCs
+ * TSP_STATS_PREEMPT: preemptions by NS interrupts, preemptions by EL3 FIQs,
+ *                    S-EL1 FIQ round trips
+ * TSP_STATS_TIME:    entries into the TSP from the normal world, total and
+ *                    longest system counter ticks spent in the secure world
+ */
+#define TSP_FID_STATS		TSP_FAST_FID(0x3001)
+#define TSP_STATS_SMC		0x0
+#define TSP_STATS_PREEMPT	0x1
+#define TSP_STATS_TIME		0x2
+
 /*
  * Identify a TSP service from function ID filtering the last 16 bits from the
  * SMC function ID
@@ -85,7 +115,7 @@
  * Total number of function IDs implemented for services offered to NS clients.
  * The function IDs are defined above
  */
-#define TSP_NUM_FID		0x4
+#define TSP_NUM_FID		0x5
 
 /* TSP implementation version numbers */
 #define TSP_VERSION_MAJOR	0x0 /* Major version */
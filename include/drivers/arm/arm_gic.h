@@ -51,7 +51,10 @@ uint32_t arm_gic_interrupt_type_to_line(uint32_t type,
 uint32_t arm_gic_get_pending_interrupt_type(void);
 uint32_t arm_gic_get_pending_interrupt_id(void);
 uint32_t arm_gic_acknowledge_interrupt(void);
+uint32_t arm_gic_get_interrupt_id(uint32_t iar);
 void arm_gic_end_of_interrupt(uint32_t id);
 uint32_t arm_gic_get_interrupt_type(uint32_t id);
+void arm_gic_set_interrupt_type(uint32_t id, uint32_t type);
+void arm_gic_raise_sgi(uint32_t id, uint64_t target);
 
 #endif /* __GIC_H__ */
@@ -48,6 +48,7 @@
 #define GIC_HIGHEST_NS_PRIORITY	128
 #define GIC_LOWEST_NS_PRIORITY	254 /* 255 would disable an interrupt */
 #define GIC_SPURIOUS_INTERRUPT	1023
+#define GICC_IAR_INTID_MASK	0x3ff
 #define GIC_TARGET_CPU_MASK	0xff
 
 #define ENABLE_GRP0		(1 << 0)
@@ -86,6 +87,10 @@
 /* GICD_TYPER bit definitions */
 #define IT_LINES_NO_MASK	0x1f
 
+/* GICD_SGIR bit definitions */
+#define SGIR_TGT_LIST_SHIFT	16
+#define SGIR_INTID_MASK		0xf
+
 /* Physical CPU Interface registers */
 #define GICC_CTLR		0x0
 #define GICC_PMR		0x4
@@ -35,11 +35,25 @@
 #include <stdint.h>
 
 
+/* GICv3 Distributor interface registers & shifts */
+#define GICD_IROUTER		0x6000
+
+/* GICD_CTLR bit definitions when the GIC supports two security states */
+#define GICD_CTLR_ARE_S		(1 << 4)
+#define GICD_CTLR_ARE_NS	(1 << 5)
+#define GICD_CTLR_RWP		(1U << 31)
+
 /* GICv3 Re-distributor interface registers & shifts */
 #define GICR_PCPUBASE_SHIFT	0x11
 #define GICR_TYPER		0x08
 #define GICR_WAKER		0x14
 
+/* GICv3 Re-distributor SGI & PPI frame registers */
+#define GICR_SGIBASE_OFFSET	0x10000
+#define GICR_IGROUPR0		0x80
+#define GICR_ISENABLER0		0x100
+#define GICR_IPRIORITYR		0x400
+
 /* GICR_WAKER bit definitions */
 #define WAKER_CA		(1UL << 2)
 #define WAKER_PS		(1UL << 1)
@@ -53,6 +67,26 @@
 #define ICC_SRE_EN		(1UL << 3)
 #define ICC_SRE_SRE		(1UL << 0)
 
+/* GICv3 ICC_IGRPEN0/1 register bit definitions */
+#define ICC_IGRPEN_EN		(1UL << 0)
+
+/* GICv3 ICC_IAR/HPPIR register definitions */
+#define ICC_INTID_MASK		0xffffff
+#define ICC_PENDING_G1S_INTID	1020
+#define ICC_PENDING_G1NS_INTID	1021
+
+/*
+ * GICv3 ICC_SGI0R register bit definitions. The target list has a bit for each
+ * of the 16 cpus whose Aff0 only differ in the bits below the range selector.
+ */
+#define ICC_SGIR_RS_AFF0_SHIFT	4
+#define ICC_SGIR_TGT_AFF0_MASK	0xf
+#define ICC_SGIR_AFF1_SHIFT	16
+#define ICC_SGIR_INTID_SHIFT	24
+#define ICC_SGIR_AFF2_SHIFT	32
+#define ICC_SGIR_RS_SHIFT	44
+#define ICC_SGIR_AFF3_SHIFT	48
+
 /*******************************************************************************
  * GICv3 defintions
  ******************************************************************************/
@@ -66,7 +100,10 @@
 /*******************************************************************************
  * Function prototypes
  ******************************************************************************/
-uintptr_t gicv3_get_rdist(uintptr_t gicr_base, uint64_t mpidr);
+void gicv3_populate_rdist_base(uintptr_t gicr_base,
+			       uintptr_t *rdist_base,
+			       unsigned int num,
+			       unsigned int (*core_pos)(unsigned long mpidr));
 
 /*******************************************************************************
  * GIC Redistributor interface accessors
@@ -86,5 +123,49 @@ static inline uint64_t gicr_read_typer(uintptr_t base)
 	return mmio_read_64(base + GICR_TYPER);
 }
 
+/*******************************************************************************
+ * GIC Redistributor SGI & PPI frame accessors. The 'base' is the address of
+ * the SGI & PPI frame of the redistributor.
+ ******************************************************************************/
+static inline uint32_t gicr_read_igroupr0(uintptr_t base)
+{
+	return mmio_read_32(base + GICR_IGROUPR0);
+}
+
+static inline void gicr_write_igroupr0(uintptr_t base, uint32_t val)
+{
+	mmio_write_32(base + GICR_IGROUPR0, val);
+}
+
+static inline void gicr_write_isenabler0(uintptr_t base, uint32_t val)
+{
+	mmio_write_32(base + GICR_ISENABLER0, val);
+}
+
+static inline void gicr_write_ipriorityr(uintptr_t base,
+					 uint32_t id,
+					 uint32_t val)
+{
+	mmio_write_32(base + GICR_IPRIORITYR + (id & ~3), val);
+}
+
+static inline void gicr_set_ipriorityr(uintptr_t base,
+				       uint32_t id,
+				       uint32_t pri)
+{
+	mmio_write_8(base + GICR_IPRIORITYR + id, pri);
+}
+
+/*******************************************************************************
+ * GIC Distributor interface accessors for registers which are only present in
+ * GICv3.
+ ******************************************************************************/
+static inline void gicd_write_irouter(uintptr_t base,
+				      uint32_t id,
+				      uint64_t affinity)
+{
+	mmio_write_64(base + GICD_IROUTER + (id << 3), affinity);
+}
+
 
 #endif /* __GIC_V3_H__ */
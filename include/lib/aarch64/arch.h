@@ -80,6 +80,15 @@
 #define ICC_CTLR_EL1    S3_0_C12_C12_4
 #define ICC_CTLR_EL3    S3_6_C12_C12_4
 #define ICC_PMR_EL1     S3_0_C4_C6_0
+#define ICC_IAR0_EL1    S3_0_C12_C8_0
+#define ICC_EOIR0_EL1   S3_0_C12_C8_1
+#define ICC_HPPIR0_EL1  S3_0_C12_C8_2
+#define ICC_IAR1_EL1    S3_0_C12_C12_0
+#define ICC_EOIR1_EL1   S3_0_C12_C12_1
+#define ICC_HPPIR1_EL1  S3_0_C12_C12_2
+#define ICC_SGI0R_EL1   S3_0_C12_C11_7
+#define ICC_IGRPEN0_EL1 S3_0_C12_C12_6
+#define ICC_IGRPEN1_EL1 S3_0_C12_C12_7
 
 /*******************************************************************************
  * Generic timer memory mapped registers & offsets
@@ -36,15 +36,39 @@
 #define BAKERY_LOCK_MAX_CPUS		PLATFORM_CORE_COUNT
 
 #ifndef __ASSEMBLY__
+#include <lock_stats.h>
 #include <stdint.h>
+#include <sys/cdefs.h>
 
 #if USE_COHERENT_MEM
 
+#if BAKERY_LOCK_PADDED
+/*
+ * The per-cpu lock data is placed in its own cache line so that contending
+ * cpus do not write to the same line when the lock memory is cacheable.
+ */
+typedef struct bakery_cpu {
+	volatile char entering;
+	volatile unsigned number;
+} __aligned(CACHE_WRITEBACK_GRANULE) bakery_cpu_t;
+
 typedef struct bakery_lock {
 	int owner;
+#if COLLECT_LOCK_STATS
+	lock_stats_t *stats;
+#endif
+	bakery_cpu_t cpu[BAKERY_LOCK_MAX_CPUS];
+} bakery_lock_t;
+#else
+typedef struct bakery_lock {
+	int owner;
+#if COLLECT_LOCK_STATS
+	lock_stats_t *stats;
+#endif
 	volatile char entering[BAKERY_LOCK_MAX_CPUS];
 	volatile unsigned number[BAKERY_LOCK_MAX_CPUS];
 } bakery_lock_t;
+#endif
 
 #define NO_OWNER (-1)
 
@@ -53,6 +77,17 @@ void bakery_lock_get(bakery_lock_t *bakery);
 void bakery_lock_release(bakery_lock_t *bakery);
 int bakery_lock_try(bakery_lock_t *bakery);
 
+#if BAKERY_LOCK_BENCHMARK
+/*
+ * Largest number of iterations of the benchmark run by one call, which bounds
+ * the time the calling cpu spends in EL3
+ */
+#define BAKERY_LOCK_BENCH_MAX_ITERATIONS	0x10000
+
+void bakery_lock_bench_init(void);
+uint64_t bakery_lock_bench(uint32_t iterations, uint64_t *max_acquire);
+#endif
+
 #else
 
 typedef struct bakery_info {
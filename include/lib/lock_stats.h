@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __LOCK_STATS_H__
+#define __LOCK_STATS_H__
+
+/*
+ * Lock statistics are only collected in BL3-1, which reports them through the
+ * SiP Service.
+ */
+#if LOCK_STATS && IMAGE_BL31
+#define COLLECT_LOCK_STATS	1
+#else
+#define COLLECT_LOCK_STATS	0
+#endif
+
+#ifndef __ASSEMBLY__
+#include <stdint.h>
+
+#if COLLECT_LOCK_STATS
+/*
+ * Statistics of a lock. They are only updated by the cpu holding the lock,
+ * so they need no protection of their own. 'acquire_ts' is the system
+ * counter value when the lock was last acquired. The times are expressed in
+ * system counter ticks.
+ */
+typedef struct lock_stats {
+	const char *name;
+	uint32_t instance;
+	uint64_t acquire_count;
+	uint64_t contended_count;
+	uint64_t wait_ticks;
+	uint64_t max_hold_ticks;
+	uint64_t acquire_ts;
+} lock_stats_t;
+
+lock_stats_t *lock_stats_register(const char *name, uint32_t instance);
+void lock_stats_acquired(lock_stats_t *stats, uint64_t start, int contended);
+void lock_stats_released(lock_stats_t *stats);
+int32_t lock_stats_get(uint32_t idx, lock_stats_t *stats);
+
+/*
+ * Attach a statistics record to a lock. This must be done after the lock has
+ * been initialised.
+ */
+#define lock_stats_attach(_lock, _name, _instance)			\
+	((_lock)->stats = lock_stats_register(_name, _instance))
+#else
+#define lock_stats_attach(_lock, _name, _instance)
+#endif
+
+#endif /* __ASSEMBLY__ */
+#endif /* __LOCK_STATS_H__ */
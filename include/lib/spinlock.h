@@ -31,11 +31,22 @@
 #ifndef __SPINLOCK_H__
 #define __SPINLOCK_H__
 
+#include <lock_stats.h>
+
 typedef struct spinlock {
 	volatile unsigned int lock;
+#if COLLECT_LOCK_STATS
+	lock_stats_t *stats;
+#endif
 } spinlock_t;
 
 void spin_lock(spinlock_t *lock);
 void spin_unlock(spinlock_t *lock);
 
+#if COLLECT_LOCK_STATS
+/* Lock primitives wrapped by the functions collecting the statistics */
+void __spin_lock(spinlock_t *lock);
+void __spin_unlock(spinlock_t *lock);
+#endif
+
 #endif /* __SPINLOCK_H__ */
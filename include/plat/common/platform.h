@@ -61,8 +61,11 @@ unsigned long plat_get_ns_image_entrypoint(void);
 uint32_t plat_ic_get_pending_interrupt_id(void);
 uint32_t plat_ic_get_pending_interrupt_type(void);
 uint32_t plat_ic_acknowledge_interrupt(void);
+uint32_t plat_ic_get_interrupt_id(uint32_t raw);
 uint32_t plat_ic_get_interrupt_type(uint32_t id);
 void plat_ic_end_of_interrupt(uint32_t id);
+void plat_ic_set_interrupt_type(uint32_t id, uint32_t type);
+void plat_ic_raise_sgi(uint32_t id, uint64_t target);
 uint32_t plat_interrupt_type_to_line(uint32_t type,
 				     uint32_t security_state);
 
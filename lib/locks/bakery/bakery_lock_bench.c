@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <arch_helpers.h>
+#include <bakery_lock.h>
+#include <stdint.h>
+
+/*
+ * Microbenchmark of the bakery lock in coherent memory. It is meant to be run
+ * concurrently on all the cpus to measure the cost of acquiring and releasing
+ * a lock under contention, e.g. to compare the lock layouts selected by
+ * BAKERY_LOCK_PADDED.
+ */
+static bakery_lock_t bench_lock __attribute__ ((section("tzfw_coherent_mem")));
+static volatile uint64_t bench_counter
+		__attribute__ ((section("tzfw_coherent_mem")));
+
+/* Initialise the benchmark lock. Called once by the primary cpu at boot. */
+void bakery_lock_bench_init(void)
+{
+	bakery_lock_init(&bench_lock);
+}
+
+/*
+ * Acquire and release the benchmark lock 'iterations' times, incrementing a
+ * shared counter in each critical section. Returns the number of system
+ * counter ticks spent in the loop and the longest time taken to acquire the
+ * lock in 'max_acquire'.
+ */
+uint64_t bakery_lock_bench(uint32_t iterations, uint64_t *max_acquire)
+{
+	uint64_t start, acquire, end;
+	uint32_t i;
+
+	*max_acquire = 0;
+	start = read_cntpct_el0();
+	for (i = 0; i < iterations; i++) {
+		acquire = read_cntpct_el0();
+		bakery_lock_get(&bench_lock);
+		acquire = read_cntpct_el0() - acquire;
+		if (acquire > *max_acquire)
+			*max_acquire = acquire;
+
+		bench_counter++;
+		bakery_lock_release(&bench_lock);
+	}
+	end = read_cntpct_el0();
+
+	return end - start;
+}
@@ -66,6 +66,15 @@
 /* Convert a ticket to priority */
 #define PRIORITY(t, pos)	(((t) << 8) | (pos))
 
+/* Accessors for the lock data of a cpu */
+#if BAKERY_LOCK_PADDED
+#define bakery_entering(bakery, pos)	((bakery)->cpu[(pos)].entering)
+#define bakery_number(bakery, pos)	((bakery)->cpu[(pos)].number)
+#else
+#define bakery_entering(bakery, pos)	((bakery)->entering[(pos)])
+#define bakery_number(bakery, pos)	((bakery)->number[(pos)])
+#endif
+
 
 /* Initialize Bakery Lock to reset ownership and all ticket values */
 void bakery_lock_init(bakery_lock_t *bakery)
@@ -95,9 +104,9 @@ static unsigned int bakery_get_ticket(bakery_lock_t *bakery, unsigned int me)
 	 * value, not the ticket value alone.
 	 */
 	my_ticket = 0;
-	bakery->entering[me] = 1;
+	bakery_entering(bakery, me) = 1;
 	for (they = 0; they < BAKERY_LOCK_MAX_CPUS; they++) {
-		their_ticket = bakery->number[they];
+		their_ticket = bakery_number(bakery, they);
 		if (their_ticket > my_ticket)
 			my_ticket = their_ticket;
 	}
@@ -107,8 +116,8 @@ static unsigned int bakery_get_ticket(bakery_lock_t *bakery, unsigned int me)
 	 * finish calculating our ticket value that we're done
 	 */
 	++my_ticket;
-	bakery->number[me] = my_ticket;
-	bakery->entering[me] = 0;
+	bakery_number(bakery, me) = my_ticket;
+	bakery_entering(bakery, me) = 0;
 
 	return my_ticket;
 }
@@ -129,6 +138,10 @@ void bakery_lock_get(bakery_lock_t *bakery)
 {
 	unsigned int they, me;
 	unsigned int my_ticket, my_prio, their_ticket;
+#if COLLECT_LOCK_STATS
+	uint64_t start = read_cntpct_el0();
+	int contended = 0;
+#endif
 
 	me = platform_get_core_pos(read_mpidr_el1());
 
@@ -150,14 +163,14 @@ void bakery_lock_get(bakery_lock_t *bakery)
 			continue;
 
 		/* Wait for the contender to get their ticket */
-		while (bakery->entering[they])
+		while (bakery_entering(bakery, they))
 			;
 
 		/*
 		 * If the other party is a contender, they'll have non-zero
 		 * (valid) ticket value. If they do, compare priorities
 		 */
-		their_ticket = bakery->number[they];
+		their_ticket = bakery_number(bakery, they);
 		if (their_ticket && (PRIORITY(their_ticket, they) < my_prio)) {
 			/*
 			 * They have higher priority (lower value). Wait for
@@ -167,12 +180,19 @@ void bakery_lock_get(bakery_lock_t *bakery)
 			 */
 			do {
 				wfe();
-			} while (their_ticket == bakery->number[they]);
+			} while (their_ticket == bakery_number(bakery, they));
+#if COLLECT_LOCK_STATS
+			contended = 1;
+#endif
 		}
 	}
 
 	/* Lock acquired */
 	bakery->owner = me;
+#if COLLECT_LOCK_STATS
+	if (bakery->stats)
+		lock_stats_acquired(bakery->stats, start, contended);
+#endif
 }
 
 
@@ -184,12 +204,17 @@ void bakery_lock_release(bakery_lock_t *bakery)
 	assert_bakery_entry_valid(me, bakery);
 	assert(bakery->owner == me);
 
+#if COLLECT_LOCK_STATS
+	if (bakery->stats)
+		lock_stats_released(bakery->stats);
+#endif
+
 	/*
 	 * Release lock by resetting ownership and ticket. Then signal other
 	 * waiting contenders
 	 */
 	bakery->owner = NO_OWNER;
-	bakery->number[me] = 0;
+	bakery_number(bakery, me) = 0;
 	dsb();
 	sev();
 }
@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <arch_helpers.h>
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+#include <lock_stats.h>
+#include <platform_def.h>
+#include <psci.h>
+#include <spinlock.h>
+#include <stdint.h>
+
+/*
+ * Maximum number of locks whose statistics are collected. There is one lock
+ * per PSCI affinity instance plus a few locks used by the platform.
+ */
+#ifndef PLAT_MAX_LOCK_STATS
+#define PLAT_MAX_LOCK_STATS	(PSCI_NUM_AFFS + 8)
+#endif
+
+/*
+ * Registry of the lock statistics. It is placed in coherent memory as locks
+ * may be acquired by cpus whose data cache is disabled.
+ */
+static lock_stats_t lock_stats[PLAT_MAX_LOCK_STATS]
+		__attribute__ ((section("tzfw_coherent_mem")));
+static uint32_t lock_stats_count __attribute__ ((section("tzfw_coherent_mem")));
+
+/*******************************************************************************
+ * This function allocates the statistics record of a lock. 'name' and
+ * 'instance' identify the lock in the log. It is only called by the primary
+ * cpu during cold boot. NULL is returned once the registry is full, in which
+ * case no statistics are collected for the lock.
+ ******************************************************************************/
+lock_stats_t *lock_stats_register(const char *name, uint32_t instance)
+{
+	lock_stats_t *stats;
+
+	assert(name);
+
+	if (lock_stats_count == PLAT_MAX_LOCK_STATS) {
+		WARN("No room for the statistics of lock %s[%u]\n",
+		     name, instance);
+		return NULL;
+	}
+
+	stats = &lock_stats[lock_stats_count];
+	stats->name = name;
+	stats->instance = instance;
+
+	INFO("BL3-1: Lock statistics %u: %s[%u]\n", lock_stats_count,
+	     name, instance);
+	lock_stats_count++;
+
+	return stats;
+}
+
+/*******************************************************************************
+ * This function is called by a cpu once it has acquired a lock. 'start' is the
+ * system counter value when it asked for the lock and 'contended' is set if it
+ * had to wait for another cpu to release it.
+ ******************************************************************************/
+void lock_stats_acquired(lock_stats_t *stats, uint64_t start, int contended)
+{
+	uint64_t now = read_cntpct_el0();
+
+	stats->acquire_count++;
+	if (contended)
+		stats->contended_count++;
+	stats->wait_ticks += now - start;
+	stats->acquire_ts = now;
+}
+
+/*******************************************************************************
+ * This function is called by a cpu just before it releases a lock.
+ ******************************************************************************/
+void lock_stats_released(lock_stats_t *stats)
+{
+	uint64_t hold = read_cntpct_el0() - stats->acquire_ts;
+
+	if (hold > stats->max_hold_ticks)
+		stats->max_hold_ticks = hold;
+}
+
+/*******************************************************************************
+ * This function returns a copy of the statistics record 'idx' of the registry.
+ * The record is read while other cpus may update it, so its fields are not
+ * guaranteed to be consistent with each other.
+ ******************************************************************************/
+int32_t lock_stats_get(uint32_t idx, lock_stats_t *stats)
+{
+	assert(stats);
+
+	if (idx >= lock_stats_count)
+		return -EINVAL;
+
+	*stats = lock_stats[idx];
+
+	return 0;
+}
+
+/*******************************************************************************
+ * Wrappers of the spin lock primitives which collect the statistics of the
+ * lock. The lock is contended if it is already held when it is asked for.
+ ******************************************************************************/
+void spin_lock(spinlock_t *lock)
+{
+	uint64_t start = read_cntpct_el0();
+	int contended = lock->lock != 0;
+
+	__spin_lock(lock);
+	if (lock->stats)
+		lock_stats_acquired(lock->stats, start, contended);
+}
+
+void spin_unlock(spinlock_t *lock)
+{
+	if (lock->stats)
+		lock_stats_released(lock->stats);
+	__spin_unlock(lock);
+}
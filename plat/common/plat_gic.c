@@ -37,8 +37,11 @@
 #pragma weak plat_ic_get_pending_interrupt_id
 #pragma weak plat_ic_get_pending_interrupt_type
 #pragma weak plat_ic_acknowledge_interrupt
+#pragma weak plat_ic_get_interrupt_id
 #pragma weak plat_ic_get_interrupt_type
 #pragma weak plat_ic_end_of_interrupt
+#pragma weak plat_ic_set_interrupt_type
+#pragma weak plat_ic_raise_sgi
 #pragma weak plat_interrupt_type_to_line
 
 uint32_t plat_ic_get_pending_interrupt_id(void)
@@ -56,6 +59,11 @@ uint32_t plat_ic_acknowledge_interrupt(void)
 	return arm_gic_acknowledge_interrupt();
 }
 
+uint32_t plat_ic_get_interrupt_id(uint32_t raw)
+{
+	return arm_gic_get_interrupt_id(raw);
+}
+
 uint32_t plat_ic_get_interrupt_type(uint32_t id)
 {
 	return arm_gic_get_interrupt_type(id);
@@ -66,6 +74,16 @@ void plat_ic_end_of_interrupt(uint32_t id)
 	arm_gic_end_of_interrupt(id);
 }
 
+void plat_ic_set_interrupt_type(uint32_t id, uint32_t type)
+{
+	arm_gic_set_interrupt_type(id, type);
+}
+
+void plat_ic_raise_sgi(uint32_t id, uint64_t target)
+{
+	arm_gic_raise_sgi(id, target);
+}
+
 uint32_t plat_interrupt_type_to_line(uint32_t type,
 				uint32_t security_state)
 {
@@ -101,6 +101,7 @@ void fvp_pwrc_write_pcoffr(unsigned long mpidr)
 int fvp_pwrc_setup(void)
 {
 	fvp_lock_init(LOCK_ARG);
+	lock_stats_attach(LOCK_ARG, "pwrc_lock", 0);
 
 	return 0;
 }
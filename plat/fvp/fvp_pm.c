@@ -281,8 +281,11 @@ void fvp_affinst_on_finish(unsigned int afflvl,
 	/* Enable the gic cpu interface */
 	arm_gic_cpuif_setup();
 
-	/* TODO: This setup is needed only after a cold boot */
-	arm_gic_pcpu_distif_setup();
+	/* The distributor interface setup is retained by the gic */
+	if (!psci_get_pcpu_init_done(PSCI_PCPU_INIT_GIC_DISTIF)) {
+		arm_gic_pcpu_distif_setup();
+		psci_set_pcpu_init_done(PSCI_PCPU_INIT_GIC_DISTIF);
+	}
 }
 
 /*******************************************************************************
@@ -345,6 +348,34 @@ int fvp_validate_power_state(unsigned int power_state)
 	return PSCI_E_SUCCESS;
 }
 
+/*******************************************************************************
+ * FVP power states which can be requested through CPU_SUSPEND along with their
+ * cost, from the shallowest to the deepest one.
+ ******************************************************************************/
+static const plat_idle_state_t fvp_idle_states[] = {
+	{
+		.power_state = psci_make_powerstate(0, PSTATE_TYPE_STANDBY,
+						    MPIDR_AFFLVL0),
+		.entry_latency = 1,
+		.exit_latency = 1,
+		.min_residency = 1,
+	},
+	{
+		.power_state = psci_make_powerstate(0, PSTATE_TYPE_POWERDOWN,
+						    MPIDR_AFFLVL0),
+		.entry_latency = 40,
+		.exit_latency = 100,
+		.min_residency = 150,
+	},
+	{
+		.power_state = psci_make_powerstate(0, PSTATE_TYPE_POWERDOWN,
+						    MPIDR_AFFLVL1),
+		.entry_latency = 500,
+		.exit_latency = 1000,
+		.min_residency = 2500,
+	},
+};
+
 /*******************************************************************************
  * Export the platform handlers to enable psci to invoke them
  ******************************************************************************/
@@ -357,7 +388,10 @@ static const plat_pm_ops_t fvp_plat_pm_ops = {
 	.affinst_suspend_finish = fvp_affinst_suspend_finish,
 	.system_off = fvp_system_off,
 	.system_reset = fvp_system_reset,
-	.validate_power_state = fvp_validate_power_state
+	.validate_power_state = fvp_validate_power_state,
+	.idle_states = fvp_idle_states,
+	.num_idle_states = sizeof(fvp_idle_states) /
+			   sizeof(fvp_idle_states[0])
 };
 
 /*******************************************************************************
@@ -186,13 +186,22 @@ void hikey_affinst_on_finish(uint32_t afflvl, uint32_t state)
 	hisi_pwrc_set_core_bx_addr(cpu, cluster, 0);
 
 	if (psci_get_suspend_stateid() == PLAT_SOC_SUSPEND_STATE) {
+		/*
+		 * The gic has lost its state, including the per-cpu
+		 * distributor interface setup of all the cpus.
+		 */
 		arm_gic_setup();
+		psci_clear_pcpu_init_done(PSCI_PCPU_INIT_GIC_DISTIF);
+		psci_set_pcpu_init_done(PSCI_PCPU_INIT_GIC_DISTIF);
 	} else {
 		/* Enable the gic cpu interface */
 		arm_gic_cpuif_setup();
 
-		/* TODO: This setup is needed only after a cold boot */
-		arm_gic_pcpu_distif_setup();
+		/* The distributor interface setup is retained by the gic */
+		if (!psci_get_pcpu_init_done(PSCI_PCPU_INIT_GIC_DISTIF)) {
+			arm_gic_pcpu_distif_setup();
+			psci_set_pcpu_init_done(PSCI_PCPU_INIT_GIC_DISTIF);
+		}
 	}
 
 	return;
@@ -236,6 +245,27 @@ unsigned int hikey_get_sys_suspend_power_state(void)
 	return power_state;
 }
 
+/*******************************************************************************
+ * HiKey power states which can be requested through CPU_SUSPEND along with
+ * their cost, from the shallowest to the deepest one.
+ ******************************************************************************/
+static const plat_idle_state_t hikey_idle_states[] = {
+	{
+		.power_state = psci_make_powerstate(0, PSTATE_TYPE_POWERDOWN,
+						    MPIDR_AFFLVL0),
+		.entry_latency = 700,
+		.exit_latency = 250,
+		.min_residency = 1000,
+	},
+	{
+		.power_state = psci_make_powerstate(0, PSTATE_TYPE_POWERDOWN,
+						    MPIDR_AFFLVL1),
+		.entry_latency = 1000,
+		.exit_latency = 700,
+		.min_residency = 2700,
+	},
+};
+
 static const plat_pm_ops_t hikey_plat_pm_ops = {
 	.affinst_on		     = hikey_affinst_on,
 	.affinst_on_finish	     = hikey_affinst_on_finish,
@@ -246,6 +276,9 @@ static const plat_pm_ops_t hikey_plat_pm_ops = {
 	.system_off		     = hikey_system_off,
 	.system_reset		     = hikey_system_reset,
 	.get_sys_suspend_power_state = hikey_get_sys_suspend_power_state,
+	.idle_states		     = hikey_idle_states,
+	.num_idle_states	     = sizeof(hikey_idle_states) /
+				       sizeof(hikey_idle_states[0]),
 };
 
 int platform_setup_pm(const plat_pm_ops_t **plat_ops)
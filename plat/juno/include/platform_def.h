@@ -198,6 +198,11 @@
  ******************************************************************************/
 #define TSP_IRQ_SEC_PHY_TIMER		IRQ_SEC_PHY_TIMER
 
+/*******************************************************************************
+ * ID of the secure SGI used by the TSPD to wake up the TSP on its worker cpu
+ ******************************************************************************/
+#define TSP_IRQ_WORKER_SGI		IRQ_SEC_SGI_7
+
 /*******************************************************************************
  * Declarations and constants to access the mailboxes safely. Each mailbox is
  * aligned on the biggest cache line size in the platform. This is known only
@@ -94,6 +94,7 @@ void mhu_secure_message_end(void)
 void mhu_secure_init(void)
 {
 	juno_lock_init(LOCK_ARG);
+	lock_stats_attach(LOCK_ARG, "mhu_secure_lock", 0);
 
 	/*
 	 * Clear the CPU's INTR register to make sure we don't see a stale
@@ -165,8 +165,11 @@ void juno_affinst_on_finish(uint32_t afflvl, uint32_t state)
 	/* Enable the gic cpu interface */
 	arm_gic_cpuif_setup();
 
-	/* Juno todo: Is this setup only needed after a cold boot? */
-	arm_gic_pcpu_distif_setup();
+	/* The distributor interface setup is retained by the gic */
+	if (!psci_get_pcpu_init_done(PSCI_PCPU_INIT_GIC_DISTIF)) {
+		arm_gic_pcpu_distif_setup();
+		psci_set_pcpu_init_done(PSCI_PCPU_INIT_GIC_DISTIF);
+	}
 
 	/* Clear the mailbox for this cpu. */
 	juno_program_mailbox(mpidr, 0);
@@ -318,6 +321,34 @@ void juno_affinst_standby(unsigned int power_state)
 	write_scr_el3(scr);
 }
 
+/*******************************************************************************
+ * Juno power states which can be requested through CPU_SUSPEND along with their
+ * cost, from the shallowest to the deepest one.
+ ******************************************************************************/
+static const plat_idle_state_t juno_idle_states[] = {
+	{
+		.power_state = psci_make_powerstate(0, PSTATE_TYPE_STANDBY,
+						    MPIDR_AFFLVL0),
+		.entry_latency = 1,
+		.exit_latency = 1,
+		.min_residency = 1,
+	},
+	{
+		.power_state = psci_make_powerstate(0, PSTATE_TYPE_POWERDOWN,
+						    MPIDR_AFFLVL0),
+		.entry_latency = 300,
+		.exit_latency = 1200,
+		.min_residency = 2000,
+	},
+	{
+		.power_state = psci_make_powerstate(0, PSTATE_TYPE_POWERDOWN,
+						    MPIDR_AFFLVL1),
+		.entry_latency = 400,
+		.exit_latency = 1200,
+		.min_residency = 2500,
+	},
+};
+
 /*******************************************************************************
  * Export the platform handlers to enable psci to invoke them
  ******************************************************************************/
@@ -330,7 +361,10 @@ static const plat_pm_ops_t juno_ops = {
 	.affinst_suspend_finish	= juno_affinst_suspend_finish,
 	.system_off		= juno_system_off,
 	.system_reset		= juno_system_reset,
-	.validate_power_state	= juno_validate_power_state
+	.validate_power_state	= juno_validate_power_state,
+	.idle_states		= juno_idle_states,
+	.num_idle_states	= sizeof(juno_idle_states) /
+				  sizeof(juno_idle_states[0])
 };
 
 /*******************************************************************************
@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <bakery_lock.h>
+#include <debug.h>
+#include <interrupt_mgmt.h>
+#include <lock_stats.h>
+#include <psci.h>
+#include <runtime_svc.h>
+#include <sip_svc.h>
+#include <stdint.h>
+#include <uuid.h>
+
+/* SiP Service UUID */
+DEFINE_SVC_UUID(sip_svc_uid,
+		0x3c8c7e89, 0xe78f, 0x4a75, 0x9f, 0x66,
+		0x04, 0x25, 0x4a, 0xc7, 0xdb, 0x2b);
+
+/* Number of SiP Service Calls implemented in this build */
+#define SIP_SVC_NUM_CALLS	(4 + INTR_LATENCY_STATS +		\
+				 BAKERY_LOCK_BENCHMARK + LOCK_STATS)
+
+#if INTR_LATENCY_STATS
+/*
+ * Return the count of a bucket of an interrupt latency histogram and the
+ * maximum latency in that histogram for the cpu identified by 'mpidr'.
+ */
+static uint64_t sip_intr_lat_stats(uint64_t mpidr,
+				   uint64_t hist,
+				   uint64_t bucket,
+				   void *handle)
+{
+	uint64_t count, max;
+
+	if (intr_lat_stats_get(mpidr, hist, bucket, &count, &max))
+		SMC_RET1(handle, SMC_UNK);
+
+	SMC_RET2(handle, count, max);
+}
+#endif
+
+#if LOCK_STATS
+/*
+ * Return the number of acquisitions, the number of contended acquisitions, the
+ * total time spent waiting and the maximum hold time of the lock registered at
+ * index 'idx' of the lock statistics registry.
+ */
+static uint64_t sip_lock_stats(uint64_t idx, void *handle)
+{
+	lock_stats_t stats;
+
+	if (lock_stats_get(idx, &stats))
+		SMC_RET1(handle, SMC_UNK);
+
+	SMC_RET4(handle, stats.acquire_count, stats.contended_count,
+		 stats.wait_ticks, stats.max_hold_ticks);
+}
+#endif
+
+/* Setup SiP Services */
+static int32_t sip_svc_setup(void)
+{
+#if BAKERY_LOCK_BENCHMARK
+	bakery_lock_bench_init();
+#endif
+	return 0;
+}
+
+/*
+ * Top-level SiP Service SMC handler.
+ */
+uint64_t sip_svc_smc_handler(uint32_t smc_fid,
+			     uint64_t x1,
+			     uint64_t x2,
+			     uint64_t x3,
+			     uint64_t x4,
+			     void *cookie,
+			     void *handle,
+			     uint64_t flags)
+{
+	switch (smc_fid) {
+#if INTR_LATENCY_STATS
+	case SIP_SVC_INTR_LAT_STATS:
+		return sip_intr_lat_stats(x1, x2, x3, handle);
+#endif
+
+#if BAKERY_LOCK_BENCHMARK
+	case SIP_SVC_BAKERY_LOCK_BENCH:
+	{
+		uint64_t total, max_acquire;
+
+		if (x1 > BAKERY_LOCK_BENCH_MAX_ITERATIONS)
+			SMC_RET1(handle, SMC_UNK);
+
+		total = bakery_lock_bench(x1, &max_acquire);
+		SMC_RET2(handle, total, max_acquire);
+	}
+#endif
+
+#if LOCK_STATS
+	case SIP_SVC_LOCK_STATS:
+		return sip_lock_stats(x1, handle);
+#endif
+
+	case SIP_SVC_CPU_ON_BATCH:
+	{
+		unsigned long on_mask;
+		int rc;
+
+		/* Apply the same checks as PSCI to a CPU_ON request */
+		if (is_caller_secure(flags))
+			SMC_RET1(handle, SMC_UNK);
+
+		if (psci_features(PSCI_CPU_ON_AARCH64) == PSCI_E_NOT_SUPPORTED)
+			SMC_RET1(handle, SMC_UNK);
+
+		rc = psci_cpu_on_batch(x1, x2, x3, x4, &on_mask);
+		SMC_RET2(handle, rc, on_mask);
+	}
+
+	case SIP_SVC_CALL_COUNT:
+		/* Return the number of SiP Service Calls */
+		SMC_RET1(handle, SIP_SVC_NUM_CALLS);
+
+	case SIP_SVC_UID:
+		/* Return UID to the caller */
+		SMC_UUID_RET(handle, sip_svc_uid);
+
+	case SIP_SVC_VERSION:
+		/* Return the version of current implementation */
+		SMC_RET2(handle, SIP_SVC_VERSION_MAJOR, SIP_SVC_VERSION_MINOR);
+
+	default:
+		WARN("Unimplemented SiP Service Call: 0x%x \n", smc_fid);
+		SMC_RET1(handle, SMC_UNK);
+	}
+}
+
+/* Register SiP Service Calls as runtime service */
+DECLARE_RT_SVC(
+		sip_svc,
+
+		OEN_SIP_START,
+		OEN_SIP_END,
+		SMC_TYPE_FAST,
+		sip_svc_setup,
+		sip_svc_smc_handler
+);
@@ -37,3 +37,32 @@ SPD_SOURCES		:=	services/spd/opteed/opteed_common.c	\
 				services/spd/opteed/opteed_pm.c
 
 NEED_BL32		:=	yes
+
+# Flag used to let the normal world register a per-cpu request ring and
+# notify OPTEE of the requests posted in it with a single doorbell SMC.
+OPTEED_RING_DOORBELL	:=	0
+
+$(eval $(call assert_boolean,OPTEED_RING_DOORBELL))
+$(eval $(call add_define,OPTEED_RING_DOORBELL))
+
+# Flag used to skip the swap of the EL1 system registers around fast calls
+# when OPTEE advertises that its fast call handlers do not need them.
+OPTEED_FAST_SMC_NO_EL1_SWAP	:=	0
+
+$(eval $(call assert_boolean,OPTEED_FAST_SMC_NO_EL1_SWAP))
+$(eval $(call add_define,OPTEED_FAST_SMC_NO_EL1_SWAP))
+
+# Flag used to route non-secure interrupts to EL3 while OPTEE runs a standard
+# call, so that the call is preempted and resumed later by the normal world.
+OPTEED_ROUTE_IRQ_TO_EL3	:=	0
+
+$(eval $(call assert_boolean,OPTEED_ROUTE_IRQ_TO_EL3))
+$(eval $(call add_define,OPTEED_ROUTE_IRQ_TO_EL3))
+
+# Flag used to defer the entry into OPTEE after a cpu has been turned on or
+# resumed until the first secure call or S-EL1 interrupt on that cpu, instead
+# of doing it in the PSCI power management hooks.
+OPTEED_LAZY_CPU_INIT	:=	0
+
+$(eval $(call assert_boolean,OPTEED_LAZY_CPU_INIT))
+$(eval $(call add_define,OPTEED_LAZY_CPU_INIT))
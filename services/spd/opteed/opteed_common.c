@@ -56,6 +56,11 @@ void opteed_init_optee_ep_state(struct entry_point_info *optee_entry_point,
 	optee_ctx->mpidr = read_mpidr_el1();
 	optee_ctx->state = 0;
 	set_optee_pstate(optee_ctx->state, OPTEE_PSTATE_OFF);
+#if OPTEED_RING_DOORBELL
+	/* The normal world registers its ring again after a cpu is turned on */
+	optee_ctx->ring_base = 0;
+	optee_ctx->ring_size = 0;
+#endif
 
 	cm_set_context(&optee_ctx->cpu_ctx, SECURE);
 
@@ -79,6 +84,23 @@ void opteed_init_optee_ep_state(struct entry_point_info *optee_entry_point,
 	optee_entry_point->args.arg1 = mem_limit;
 }
 
+#if OPTEED_ROUTE_IRQ_TO_EL3
+/*******************************************************************************
+ * This function returns the SPSR_EL3 value to enter OPTEE with all exceptions
+ * masked in its execution state. It is used when OPTEE is entered on behalf of
+ * the OPTEED while a standard call is preempted, since the SPSR_EL3 of that
+ * call may have interrupts unmasked.
+ ******************************************************************************/
+uint32_t opteed_masked_spsr(void)
+{
+	if (opteed_rw == OPTEE_AARCH64)
+		return SPSR_64(MODE_EL1, MODE_SP_ELX, DISABLE_ALL_EXCEPTIONS);
+
+	return SPSR_MODE32(MODE32_svc, SPSR_T_ARM, SPSR_E_LITTLE,
+			   DAIF_FIQ_BIT | DAIF_IRQ_BIT | DAIF_ABT_BIT);
+}
+#endif
+
 /*******************************************************************************
  * This function takes an OPTEE context pointer and:
  * 1. Applies the S-EL1 system register context from optee_ctx->cpu_ctx.
@@ -129,3 +151,78 @@ void opteed_synchronous_sp_exit(optee_context_t *optee_ctx, uint64_t ret)
 	/* Should never reach here */
 	assert(0);
 }
+
+#if OPTEED_FAST_SMC_NO_EL1_SWAP
+/*******************************************************************************
+ * These functions switch the EL1 system registers that OPTEE needs to serve a
+ * fast call in its own translation regime: SCTLR_EL1, TTBR0_EL1, TTBR1_EL1,
+ * TCR_EL1, MAIR_EL1, VBAR_EL1 and SP_EL1, along with the ones that OPTEE may
+ * change by taking an exception or using the thread and context id registers:
+ * ESR_EL1, ELR_EL1, SPSR_EL1, FAR_EL1, TPIDR_EL1, CPACR_EL1 and
+ * CONTEXTIDR_EL1. They are not banked between the security states. On entry,
+ * the non-secure values are saved in the non-secure context and the values
+ * OPTEE last ran with are loaded from the secure context. The secure values
+ * are not saved back on exit since OPTEE must leave the translation regime
+ * unchanged and the others only hold per call state. The other EL1 system
+ * registers are not switched.
+ ******************************************************************************/
+void opteed_fast_el1_regs_enter(optee_context_t *optee_ctx)
+{
+	el1_sys_regs_t *ns_regs, *s_regs;
+
+	ns_regs = get_sysregs_ctx(cm_get_context(NON_SECURE));
+	s_regs = get_sysregs_ctx(&optee_ctx->cpu_ctx);
+
+	write_ctx_reg(ns_regs, CTX_SCTLR_EL1, read_sctlr_el1());
+	write_ctx_reg(ns_regs, CTX_TTBR0_EL1, read_ttbr0_el1());
+	write_ctx_reg(ns_regs, CTX_TTBR1_EL1, read_ttbr1_el1());
+	write_ctx_reg(ns_regs, CTX_TCR_EL1, read_tcr_el1());
+	write_ctx_reg(ns_regs, CTX_MAIR_EL1, read_mair_el1());
+	write_ctx_reg(ns_regs, CTX_VBAR_EL1, read_vbar_el1());
+	write_ctx_reg(ns_regs, CTX_SP_EL1, read_sp_el1());
+	write_ctx_reg(ns_regs, CTX_ESR_EL1, read_esr_el1());
+	write_ctx_reg(ns_regs, CTX_ELR_EL1, read_elr_el1());
+	write_ctx_reg(ns_regs, CTX_SPSR_EL1, read_spsr_el1());
+	write_ctx_reg(ns_regs, CTX_FAR_EL1, read_far_el1());
+	write_ctx_reg(ns_regs, CTX_TPIDR_EL1, read_tpidr_el1());
+	write_ctx_reg(ns_regs, CTX_CPACR_EL1, read_cpacr_el1());
+	write_ctx_reg(ns_regs, CTX_CONTEXTIDR_EL1, read_contextidr_el1());
+
+	write_sctlr_el1(read_ctx_reg(s_regs, CTX_SCTLR_EL1));
+	write_ttbr0_el1(read_ctx_reg(s_regs, CTX_TTBR0_EL1));
+	write_ttbr1_el1(read_ctx_reg(s_regs, CTX_TTBR1_EL1));
+	write_tcr_el1(read_ctx_reg(s_regs, CTX_TCR_EL1));
+	write_mair_el1(read_ctx_reg(s_regs, CTX_MAIR_EL1));
+	write_vbar_el1(read_ctx_reg(s_regs, CTX_VBAR_EL1));
+	write_sp_el1(read_ctx_reg(s_regs, CTX_SP_EL1));
+	write_esr_el1(read_ctx_reg(s_regs, CTX_ESR_EL1));
+	write_elr_el1(read_ctx_reg(s_regs, CTX_ELR_EL1));
+	write_spsr_el1(read_ctx_reg(s_regs, CTX_SPSR_EL1));
+	write_far_el1(read_ctx_reg(s_regs, CTX_FAR_EL1));
+	write_tpidr_el1(read_ctx_reg(s_regs, CTX_TPIDR_EL1));
+	write_cpacr_el1(read_ctx_reg(s_regs, CTX_CPACR_EL1));
+	write_contextidr_el1(read_ctx_reg(s_regs, CTX_CONTEXTIDR_EL1));
+}
+
+void opteed_fast_el1_regs_exit(void)
+{
+	el1_sys_regs_t *ns_regs;
+
+	ns_regs = get_sysregs_ctx(cm_get_context(NON_SECURE));
+
+	write_sctlr_el1(read_ctx_reg(ns_regs, CTX_SCTLR_EL1));
+	write_ttbr0_el1(read_ctx_reg(ns_regs, CTX_TTBR0_EL1));
+	write_ttbr1_el1(read_ctx_reg(ns_regs, CTX_TTBR1_EL1));
+	write_tcr_el1(read_ctx_reg(ns_regs, CTX_TCR_EL1));
+	write_mair_el1(read_ctx_reg(ns_regs, CTX_MAIR_EL1));
+	write_vbar_el1(read_ctx_reg(ns_regs, CTX_VBAR_EL1));
+	write_sp_el1(read_ctx_reg(ns_regs, CTX_SP_EL1));
+	write_esr_el1(read_ctx_reg(ns_regs, CTX_ESR_EL1));
+	write_elr_el1(read_ctx_reg(ns_regs, CTX_ELR_EL1));
+	write_spsr_el1(read_ctx_reg(ns_regs, CTX_SPSR_EL1));
+	write_far_el1(read_ctx_reg(ns_regs, CTX_FAR_EL1));
+	write_tpidr_el1(read_ctx_reg(ns_regs, CTX_TPIDR_EL1));
+	write_cpacr_el1(read_ctx_reg(ns_regs, CTX_CPACR_EL1));
+	write_contextidr_el1(read_ctx_reg(ns_regs, CTX_CONTEXTIDR_EL1));
+}
+#endif
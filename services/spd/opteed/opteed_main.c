@@ -77,6 +77,11 @@ struct optee_header {
  ******************************************************************************/
 optee_vectors_t *optee_vectors;
 
+/*******************************************************************************
+ * Capabilities advertised by OPTEE once it has initialised, TEESMC_OPTEED_CAP_*
+ ******************************************************************************/
+uint32_t optee_caps;
+
 /*******************************************************************************
  * Array to keep track of per-cpu OPTEE state
  ******************************************************************************/
@@ -100,6 +105,7 @@ static uint64_t opteed_sel1_interrupt_handler(uint32_t id,
 	uint32_t linear_id;
 	uint64_t mpidr;
 	optee_context_t *optee_ctx;
+	cpu_context_t *sec_ctx;
 
 	/* Check the security state when the exception was generated */
 	assert(get_interrupt_src_ss(flags) == NON_SECURE);
@@ -121,10 +127,43 @@ static uint64_t opteed_sel1_interrupt_handler(uint32_t id,
 	optee_ctx = &opteed_sp_context[linear_id];
 	assert(&optee_ctx->cpu_ctx == cm_get_context(SECURE));
 
+#if OPTEED_LAZY_CPU_INIT
+	/* Let OPTEE initialise or resume itself on this cpu first */
+	opteed_complete_pm_entry(optee_ctx);
+#endif
+
+#if OPTEED_ROUTE_IRQ_TO_EL3
+	/*
+	 * OPTEE should return control to the OPTEED after handling this
+	 * FIQ. Enter it at the FIQ entry point through 'fiq_ctx' so that
+	 * 'cpu_ctx', which holds the last known state of an OPTEE preempted
+	 * during a standard call, is preserved without being copied. The
+	 * S-EL1 system registers are restored from 'cpu_ctx' before the
+	 * switch and need not be saved afterwards since OPTEE is supposed
+	 * to preserve them during S-EL1 interrupt handling. Only the
+	 * SCR_EL3 has to be carried over for el3_exit().
+	 */
+	cm_el1_sysregs_context_restore(SECURE);
+	write_ctx_reg(get_el3state_ctx(&optee_ctx->fiq_ctx), CTX_SCR_EL3,
+		read_ctx_reg(get_el3state_ctx(&optee_ctx->cpu_ctx), CTX_SCR_EL3));
+	cm_set_context(&optee_ctx->fiq_ctx, SECURE);
+	sec_ctx = &optee_ctx->fiq_ctx;
+
+	cm_set_elr_spsr_el3(SECURE, (uint64_t) &optee_vectors->fiq_entry,
+			    opteed_masked_spsr());
+#else
 	cm_set_elr_el3(SECURE, (uint64_t)&optee_vectors->fiq_entry);
 	cm_el1_sysregs_context_restore(SECURE);
+	sec_ctx = &optee_ctx->cpu_ctx;
+#endif
+
 	cm_set_next_eret_context(SECURE);
 
+#if INTR_LATENCY_STATS
+	/* Account the time taken to hand over the interrupt to S-EL1 */
+	intr_lat_stats_mark_handoff();
+#endif
+
 	/*
 	 * Tell the OPTEE that it has to handle an FIQ (synchronously).
 	 * Also the instruction in normal world where the interrupt was
@@ -132,9 +171,55 @@ static uint64_t opteed_sel1_interrupt_handler(uint32_t id,
 	 * retrieve this address from ELR_EL3 as the secure context will
 	 * not take effect until el3_exit().
 	 */
-	SMC_RET1(&optee_ctx->cpu_ctx, read_elr_el3());
+	SMC_RET1(sec_ctx, read_elr_el3());
 }
 
+#if OPTEED_ROUTE_IRQ_TO_EL3
+/*******************************************************************************
+ * This function is the handler registered for non-secure interrupts by the
+ * OPTEED when they are generated while OPTEE runs a standard call. It saves
+ * the secure context, which stays marked as having a standard call active,
+ * and returns SMC_PREEMPTED to the normal world so that the interrupt can be
+ * handled there. The call is later resumed through TEESMC_OPTEED_RESUME.
+ ******************************************************************************/
+static uint64_t opteed_ns_interrupt_handler(uint32_t id,
+					    uint32_t flags,
+					    void *handle,
+					    void *cookie)
+{
+	cpu_context_t *ns_cpu_context;
+
+	/* Check the security state when the exception was generated */
+	assert(get_interrupt_src_ss(flags) == SECURE);
+
+#if IMF_READ_INTERRUPT_ID
+	/* Check the security status of the interrupt */
+	assert(plat_ic_get_interrupt_type(id) == INTR_TYPE_NS);
+#endif
+	/*
+	 * Disable the routing of NS interrupts from secure world to EL3 while
+	 * interrupted on this core.
+	 */
+	disable_intr_rm_local(INTR_TYPE_NS, SECURE);
+
+	assert(handle == cm_get_context(SECURE));
+	cm_el1_sysregs_context_save(SECURE);
+
+	/* Get a reference to the non-secure context */
+	ns_cpu_context = cm_get_context(NON_SECURE);
+	assert(ns_cpu_context);
+
+	/*
+	 * Restore non-secure state. The secure system register context has
+	 * been saved above for the resumption of the call.
+	 */
+	cm_el1_sysregs_context_restore(NON_SECURE);
+	cm_set_next_eret_context(NON_SECURE);
+
+	SMC_RET1(ns_cpu_context, SMC_PREEMPTED);
+}
+#endif
+
 
 static int is_mem_free(uint64_t free_base, size_t free_size,
 		       uint64_t addr, size_t size)
@@ -331,6 +416,32 @@ static int32_t opteed_init(void)
 }
 
 
+#if OPTEED_RING_DOORBELL
+/*******************************************************************************
+ * This function validates a request ring that the normal world wants to
+ * register for this cpu. The ring must be page aligned and must not overlap
+ * the memory given to OPTEE, so that the normal world cannot make OPTEE serve
+ * requests out of its own memory. OPTEE remains responsible for checking that
+ * the ring lies in memory it is allowed to map as non-secure.
+ ******************************************************************************/
+static int opteed_ring_is_valid(uint64_t base, uint64_t size)
+{
+	if (!size || (base & PAGE_SIZE_MASK) || (size & PAGE_SIZE_MASK))
+		return 0;
+
+	if (base + size < base)
+		return 0;
+
+	if (base < BL32_SRAM_LIMIT && base + size > BL32_SRAM_BASE)
+		return 0;
+
+	if (base < BL32_DRAM_LIMIT && base + size > BL32_DRAM_BASE)
+		return 0;
+
+	return 1;
+}
+#endif
+
 /*******************************************************************************
  * This function is responsible for handling all SMCs in the Trusted OS/App
  * range from the non-secure state as defined in the SMC Calling Convention
@@ -367,6 +478,91 @@ uint64_t opteed_smc_handler(uint32_t smc_fid,
 		 */
 		assert(handle == cm_get_context(NON_SECURE));
 
+#if OPTEED_RING_DOORBELL
+		/*
+		 * The registration of a request ring is handled here without
+		 * entering OPTEE. A doorbell is only forwarded to OPTEE if
+		 * this cpu has a ring to drain.
+		 */
+		if (smc_fid == TEESMC_OPTEED_RING_REGISTER) {
+			if (x2 && !opteed_ring_is_valid(x1, x2))
+				SMC_RET1(handle, SMC_UNK);
+
+			optee_ctx->ring_base = x2 ? x1 : 0;
+			optee_ctx->ring_size = x2;
+			SMC_RET1(handle, 0);
+		}
+
+		if (smc_fid == TEESMC_OPTEED_RING_DOORBELL &&
+		    !optee_ctx->ring_size)
+			SMC_RET1(handle, SMC_UNK);
+#endif
+
+#if OPTEED_LAZY_CPU_INIT
+		/*
+		 * Let OPTEE initialise or resume itself on this cpu first. The
+		 * non-secure EL1 system registers are preserved around this
+		 * entry as some of the paths below do not switch them.
+		 */
+		if (get_optee_pstate(optee_ctx->state) != OPTEE_PSTATE_ON) {
+			cm_el1_sysregs_context_save(NON_SECURE);
+			opteed_complete_pm_entry(optee_ctx);
+			cm_el1_sysregs_context_restore(NON_SECURE);
+		}
+#endif
+
+#if OPTEED_ROUTE_IRQ_TO_EL3
+		/*
+		 * A standard call preempted by a non-secure interrupt is
+		 * resumed where it was left. No other call is accepted until
+		 * it has completed.
+		 */
+		if (smc_fid == TEESMC_OPTEED_RESUME) {
+			if (!get_optee_std_smc_active(optee_ctx->state))
+				SMC_RET1(handle, SMC_UNK);
+
+			cm_el1_sysregs_context_save(NON_SECURE);
+
+			/*
+			 * Enable the routing of NS interrupts to EL3 during
+			 * resumption of the standard call on this core.
+			 */
+			enable_intr_rm_local(INTR_TYPE_NS, SECURE);
+
+			cm_el1_sysregs_context_restore(SECURE);
+			cm_set_next_eret_context(SECURE);
+			SMC_RET0(&optee_ctx->cpu_ctx);
+		}
+
+		if (get_optee_std_smc_active(optee_ctx->state))
+			SMC_RET1(handle, SMC_UNK);
+#endif
+
+#if OPTEED_FAST_SMC_NO_EL1_SWAP
+		/*
+		 * OPTEE can serve fast calls with only the EL1 system
+		 * registers it needs to run in its own translation regime
+		 * switched in, besides the EL3 state.
+		 */
+		if (GET_SMC_TYPE(smc_fid) == SMC_TYPE_FAST &&
+		    (optee_caps & TEESMC_OPTEED_CAP_FAST_NO_EL1_SWAP)) {
+			assert(&optee_ctx->cpu_ctx == cm_get_context(SECURE));
+
+			opteed_fast_el1_regs_enter(optee_ctx);
+			set_optee_fast_no_el1_swap(optee_ctx->state);
+			cm_set_elr_el3(SECURE, (uint64_t)
+					&optee_vectors->fast_smc_entry);
+			cm_set_next_eret_context(SECURE);
+
+			write_ctx_reg(get_gpregs_ctx(&optee_ctx->cpu_ctx),
+				      CTX_GPREG_X7,
+				      read_ctx_reg(get_gpregs_ctx(handle),
+						   CTX_GPREG_X7));
+
+			SMC_RET4(&optee_ctx->cpu_ctx, smc_fid, x1, x2, x3);
+		}
+#endif
+
 		cm_el1_sysregs_context_save(NON_SECURE);
 
 		/*
@@ -393,6 +589,14 @@ uint64_t opteed_smc_handler(uint32_t smc_fid,
 		} else {
 			cm_set_elr_el3(SECURE, (uint64_t)
 					&optee_vectors->std_smc_entry);
+#if OPTEED_ROUTE_IRQ_TO_EL3
+			/*
+			 * Enable the routing of NS interrupts to EL3 during
+			 * the standard call on this core.
+			 */
+			set_optee_std_smc_active(optee_ctx->state);
+			enable_intr_rm_local(INTR_TYPE_NS, SECURE);
+#endif
 		}
 
 		cm_el1_sysregs_context_restore(SECURE);
@@ -404,6 +608,17 @@ uint64_t opteed_smc_handler(uint32_t smc_fid,
 			      read_ctx_reg(get_gpregs_ctx(handle),
 					   CTX_GPREG_X7));
 
+#if OPTEED_RING_DOORBELL
+		/*
+		 * Describe the ring in place of the arguments so that OPTEE
+		 * can serve all the posted requests before returning.
+		 */
+		if (smc_fid == TEESMC_OPTEED_RING_DOORBELL)
+			SMC_RET4(&optee_ctx->cpu_ctx, smc_fid,
+				 optee_ctx->ring_base, optee_ctx->ring_size,
+				 x1);
+#endif
+
 		SMC_RET4(&optee_ctx->cpu_ctx, smc_fid, x1, x2, x3);
 	}
 
@@ -422,6 +637,9 @@ uint64_t opteed_smc_handler(uint32_t smc_fid,
 		 */
 		assert(optee_vectors == NULL);
 		optee_vectors = (optee_vectors_t *) x1;
+#if OPTEED_FAST_SMC_NO_EL1_SWAP
+		optee_caps = x2;
+#endif
 
 		if (optee_vectors) {
 			set_optee_pstate(optee_ctx->state, OPTEE_PSTATE_ON);
@@ -444,6 +662,27 @@ uint64_t opteed_smc_handler(uint32_t smc_fid,
 						flags);
 			if (rc)
 				panic();
+
+#if OPTEED_ROUTE_IRQ_TO_EL3
+			/*
+			 * Register an interrupt handler for NS interrupts when
+			 * generated during code executing in secure state are
+			 * routed to EL3.
+			 */
+			flags = 0;
+			set_interrupt_rm_flag(flags, SECURE);
+			rc = register_interrupt_type_handler(INTR_TYPE_NS,
+						opteed_ns_interrupt_handler,
+						flags);
+			if (rc)
+				panic();
+
+			/*
+			 * Disable the NS interrupt locally since it will be
+			 * enabled globally within cm_init_context.
+			 */
+			disable_intr_rm_local(INTR_TYPE_NS, SECURE);
+#endif
 		}
 
 		/*
@@ -499,12 +738,37 @@ uint64_t opteed_smc_handler(uint32_t smc_fid,
 		 * and return to the non-secure state.
 		 */
 		assert(handle == cm_get_context(SECURE));
-		cm_el1_sysregs_context_save(SECURE);
 
 		/* Get a reference to the non-secure context */
 		ns_cpu_context = cm_get_context(NON_SECURE);
 		assert(ns_cpu_context);
 
+#if OPTEED_FAST_SMC_NO_EL1_SWAP
+		/*
+		 * Only the minimal set of EL1 system registers needs to be
+		 * switched back if this was a fast call entered that way.
+		 */
+		if (get_optee_fast_no_el1_swap(optee_ctx->state)) {
+			clr_optee_fast_no_el1_swap(optee_ctx->state);
+			opteed_fast_el1_regs_exit();
+			cm_set_next_eret_context(NON_SECURE);
+			SMC_RET4(ns_cpu_context, x1, x2, x3, x4);
+		}
+#endif
+
+		cm_el1_sysregs_context_save(SECURE);
+
+#if OPTEED_ROUTE_IRQ_TO_EL3
+		/*
+		 * Disable the routing of NS interrupts to EL3 after the
+		 * standard call has finished on this core.
+		 */
+		if (get_optee_std_smc_active(optee_ctx->state)) {
+			clr_optee_std_smc_active(optee_ctx->state);
+			disable_intr_rm_local(INTR_TYPE_NS, SECURE);
+		}
+#endif
+
 		/* Restore non-secure state */
 		cm_el1_sysregs_context_restore(NON_SECURE);
 		cm_set_next_eret_context(NON_SECURE);
@@ -516,6 +780,20 @@ uint64_t opteed_smc_handler(uint32_t smc_fid,
 	 * should resume in the normal world.
 	 */
 	case TEESMC_OPTEED_RETURN_FIQ_DONE:
+#if INTR_LATENCY_STATS
+		/* Account the time taken by OPTEE to handle the FIQ */
+		intr_lat_stats_mark_return();
+#endif
+
+#if OPTEED_ROUTE_IRQ_TO_EL3
+		/*
+		 * Switch back to the context in which OPTEE was running
+		 * before the FIQ was taken. It was left untouched.
+		 */
+		assert(handle == &optee_ctx->fiq_ctx);
+		cm_set_context(&optee_ctx->cpu_ctx, SECURE);
+#endif
+
 		/* Get a reference to the non-secure context */
 		ns_cpu_context = cm_get_context(NON_SECURE);
 		assert(ns_cpu_context);
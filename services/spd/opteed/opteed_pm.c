@@ -56,6 +56,21 @@ static int32_t opteed_cpu_off_handler(uint64_t unused)
 	optee_context_t *optee_ctx = &opteed_sp_context[linear_id];
 
 	assert(optee_vectors);
+
+#if OPTEED_ROUTE_IRQ_TO_EL3
+	/*
+	 * Refuse to turn this cpu off while a standard call is preempted on
+	 * it. Entering OPTEE would overwrite the state of that call, which
+	 * could then never be resumed.
+	 */
+	if (get_optee_std_smc_active(optee_ctx->state))
+		return PSCI_E_DENIED;
+#endif
+
+#if OPTEED_LAZY_CPU_INIT
+	/* Complete a deferred cpu_on or cpu_resume entry first */
+	opteed_complete_pm_entry(optee_ctx);
+#endif
 	assert(get_optee_pstate(optee_ctx->state) == OPTEE_PSTATE_ON);
 
 	/* Program the entry point and enter OPTEE */
@@ -90,8 +105,31 @@ static void opteed_cpu_suspend_handler(uint64_t unused)
 	optee_context_t *optee_ctx = &opteed_sp_context[linear_id];
 
 	assert(optee_vectors);
+
+	/*
+	 * OPTEE is left as it is if it has not been entered since this cpu was
+	 * turned on or resumed.
+	 */
+	if (OPTEED_LAZY_CPU_INIT &&
+	    get_optee_pstate(optee_ctx->state) != OPTEE_PSTATE_ON)
+		return;
+
 	assert(get_optee_pstate(optee_ctx->state) == OPTEE_PSTATE_ON);
 
+#if OPTEED_ROUTE_IRQ_TO_EL3
+	/*
+	 * Keep the state of a standard call preempted on this cpu aside
+	 * until OPTEE has been entered to resume (see
+	 * opteed_complete_pm_entry()), and enter OPTEE with all exceptions
+	 * masked instead of in the state of that call.
+	 */
+	if (get_optee_std_smc_active(optee_ctx->state)) {
+		optee_ctx->pm_ctx = optee_ctx->cpu_ctx;
+		write_ctx_reg(get_el3state_ctx(&optee_ctx->cpu_ctx),
+			      CTX_SPSR_EL3, opteed_masked_spsr());
+	}
+#endif
+
 	/* Program the entry point and enter OPTEE */
 	cm_set_elr_el3(SECURE, (uint64_t) &optee_vectors->cpu_suspend_entry);
 	rc = opteed_synchronous_sp_entry(optee_ctx);
@@ -107,6 +145,51 @@ static void opteed_cpu_suspend_handler(uint64_t unused)
 	set_optee_pstate(optee_ctx->state, OPTEE_PSTATE_SUSPEND);
 }
 
+/*******************************************************************************
+ * This function enters OPTEE on this cpu if it has been turned on or resumed
+ * since it was last entered, so that it initialises S-EL1 or does its resume
+ * book keeping. With OPTEED_LAZY_CPU_INIT, this is done upon the first secure
+ * call on this cpu instead of in the power management handlers.
+ ******************************************************************************/
+void opteed_complete_pm_entry(optee_context_t *optee_ctx)
+{
+	int32_t rc;
+
+	switch (get_optee_pstate(optee_ctx->state)) {
+	case OPTEE_PSTATE_ON:
+		return;
+	case OPTEE_PSTATE_ON_PENDING:
+		/* The context has been initialised to enter 'cpu_on_entry' */
+		break;
+	case OPTEE_PSTATE_SUSPEND:
+		/* The suspend level has been passed in x0 */
+		cm_set_elr_el3(SECURE,
+			       (uint64_t) &optee_vectors->cpu_resume_entry);
+		break;
+	default:
+		panic();
+	}
+
+	rc = opteed_synchronous_sp_entry(optee_ctx);
+
+	/*
+	 * Read the response from OPTEE. A non-zero return means that
+	 * something went wrong while communicating with OPTEE.
+	 */
+	if (rc != 0)
+		panic();
+
+#if OPTEED_ROUTE_IRQ_TO_EL3
+	/* Bring back the standard call kept aside when OPTEE was suspended */
+	if (get_optee_pstate(optee_ctx->state) == OPTEE_PSTATE_SUSPEND &&
+	    get_optee_std_smc_active(optee_ctx->state))
+		optee_ctx->cpu_ctx = optee_ctx->pm_ctx;
+#endif
+
+	/* Update its context to reflect the state OPTEE is in */
+	set_optee_pstate(optee_ctx->state, OPTEE_PSTATE_ON);
+}
+
 /*******************************************************************************
  * This cpu has been turned on. Enter OPTEE to initialise S-EL1 and other bits
  * before passing control back to the Secure Monitor. Entry in S-El1 is done
@@ -115,7 +198,6 @@ static void opteed_cpu_suspend_handler(uint64_t unused)
  ******************************************************************************/
 static void opteed_cpu_on_finish_handler(uint64_t unused)
 {
-	int32_t rc = 0;
 	uint64_t mpidr = read_mpidr();
 	uint32_t linear_id = platform_get_core_pos(mpidr);
 	optee_context_t *optee_ctx = &opteed_sp_context[linear_id];
@@ -131,18 +213,18 @@ static void opteed_cpu_on_finish_handler(uint64_t unused)
 	/* Initialise this cpu's secure context */
 	cm_init_context(mpidr, &optee_on_entrypoint);
 
-	/* Enter OPTEE */
-	rc = opteed_synchronous_sp_entry(optee_ctx);
-
+#if OPTEED_ROUTE_IRQ_TO_EL3
 	/*
-	 * Read the response from OPTEE. A non-zero return means that
-	 * something went wrong while communicating with OPTEE.
+	 * Disable the NS interrupt locally since it will be enabled globally
+	 * within cm_init_context.
 	 */
-	if (rc != 0)
-		panic();
+	disable_intr_rm_local(INTR_TYPE_NS, SECURE);
+#endif
 
-	/* Update its context to reflect the state OPTEE is in */
-	set_optee_pstate(optee_ctx->state, OPTEE_PSTATE_ON);
+	/* Enter OPTEE unless this is deferred to the first secure call */
+	set_optee_pstate(optee_ctx->state, OPTEE_PSTATE_ON_PENDING);
+	if (!OPTEED_LAZY_CPU_INIT)
+		opteed_complete_pm_entry(optee_ctx);
 }
 
 /*******************************************************************************
@@ -152,30 +234,28 @@ static void opteed_cpu_on_finish_handler(uint64_t unused)
  ******************************************************************************/
 static void opteed_cpu_suspend_finish_handler(uint64_t suspend_level)
 {
-	int32_t rc = 0;
 	uint64_t mpidr = read_mpidr();
 	uint32_t linear_id = platform_get_core_pos(mpidr);
 	optee_context_t *optee_ctx = &opteed_sp_context[linear_id];
 
 	assert(optee_vectors);
+
+	/* OPTEE is still as it was left when this cpu was turned on */
+	if (OPTEED_LAZY_CPU_INIT &&
+	    get_optee_pstate(optee_ctx->state) == OPTEE_PSTATE_ON_PENDING)
+		return;
+
 	assert(get_optee_pstate(optee_ctx->state) == OPTEE_PSTATE_SUSPEND);
 
-	/* Program the entry point, suspend_level and enter the SP */
+	/*
+	 * Pass the suspend_level and enter the SP unless this is deferred to
+	 * the first secure call
+	 */
 	write_ctx_reg(get_gpregs_ctx(&optee_ctx->cpu_ctx),
 		      CTX_GPREG_X0,
 		      suspend_level);
-	cm_set_elr_el3(SECURE, (uint64_t) &optee_vectors->cpu_resume_entry);
-	rc = opteed_synchronous_sp_entry(optee_ctx);
-
-	/*
-	 * Read the response from OPTEE. A non-zero return means that
-	 * something went wrong while communicating with OPTEE.
-	 */
-	if (rc != 0)
-		panic();
-
-	/* Update its context to reflect the state OPTEE is in */
-	set_optee_pstate(optee_ctx->state, OPTEE_PSTATE_ON);
+	if (!OPTEED_LAZY_CPU_INIT)
+		opteed_complete_pm_entry(optee_ctx);
 }
 
 /*******************************************************************************
@@ -198,6 +278,11 @@ static void opteed_system_off(void)
 	optee_context_t *optee_ctx = &opteed_sp_context[linear_id];
 
 	assert(optee_vectors);
+
+#if OPTEED_LAZY_CPU_INIT
+	/* Complete a deferred cpu_on or cpu_resume entry first */
+	opteed_complete_pm_entry(optee_ctx);
+#endif
 	assert(get_optee_pstate(optee_ctx->state) == OPTEE_PSTATE_ON);
 
 	/* Program the entry point */
@@ -219,6 +304,11 @@ static void opteed_system_reset(void)
 	optee_context_t *optee_ctx = &opteed_sp_context[linear_id];
 
 	assert(optee_vectors);
+
+#if OPTEED_LAZY_CPU_INIT
+	/* Complete a deferred cpu_on or cpu_resume entry first */
+	opteed_complete_pm_entry(optee_ctx);
+#endif
 	assert(get_optee_pstate(optee_ctx->state) == OPTEE_PSTATE_ON);
 
 	/* Program the entry point */
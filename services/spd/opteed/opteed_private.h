@@ -44,6 +44,7 @@
 #define OPTEE_PSTATE_OFF		0
 #define OPTEE_PSTATE_ON			1
 #define OPTEE_PSTATE_SUSPEND		2
+#define OPTEE_PSTATE_ON_PENDING		3	/* Turned on, not entered yet */
 #define OPTEE_PSTATE_SHIFT		0
 #define OPTEE_PSTATE_MASK		0x3
 #define get_optee_pstate(state)	((state >> OPTEE_PSTATE_SHIFT) & \
@@ -56,6 +57,39 @@
 						OPTEE_PSTATE_SHIFT;	       \
 				} while (0)
 
+/*
+ * Set while a fast call runs in OPTEE with only part of the secure EL1 system
+ * registers switched in (see opteed_fast_el1_regs_enter()), so that the return
+ * path only switches those back.
+ */
+#define OPTEE_FAST_NO_EL1_SWAP_SHIFT	2
+#define OPTEE_FAST_NO_EL1_SWAP_MASK	0x1
+#define get_optee_fast_no_el1_swap(state)				       \
+				((state >> OPTEE_FAST_NO_EL1_SWAP_SHIFT) &     \
+				 OPTEE_FAST_NO_EL1_SWAP_MASK)
+#define clr_optee_fast_no_el1_swap(state)				       \
+				(state &= ~(OPTEE_FAST_NO_EL1_SWAP_MASK	       \
+					    << OPTEE_FAST_NO_EL1_SWAP_SHIFT))
+#define set_optee_fast_no_el1_swap(state)				       \
+				(state |= OPTEE_FAST_NO_EL1_SWAP_MASK	       \
+					  << OPTEE_FAST_NO_EL1_SWAP_SHIFT)
+
+/*
+ * Set while a standard call is in progress in OPTEE, including while it is
+ * preempted by a normal world interrupt and waits to be resumed.
+ */
+#define OPTEE_STD_SMC_ACTIVE_SHIFT	3
+#define OPTEE_STD_SMC_ACTIVE_MASK	0x1
+#define get_optee_std_smc_active(state)					       \
+				((state >> OPTEE_STD_SMC_ACTIVE_SHIFT) &       \
+				 OPTEE_STD_SMC_ACTIVE_MASK)
+#define clr_optee_std_smc_active(state)					       \
+				(state &= ~(OPTEE_STD_SMC_ACTIVE_MASK	       \
+					    << OPTEE_STD_SMC_ACTIVE_SHIFT))
+#define set_optee_std_smc_active(state)					       \
+				(state |= OPTEE_STD_SMC_ACTIVE_MASK	       \
+					  << OPTEE_STD_SMC_ACTIVE_SHIFT)
+
 
 /*******************************************************************************
  * OPTEE execution state information i.e. aarch32 or aarch64
@@ -145,12 +179,30 @@ CASSERT(OPTEED_C_RT_CTX_SIZE == sizeof(c_rt_regs_t),	\
  * 'c_rt_ctx'       - stack address to restore C runtime context from after
  *                    returning from a synchronous entry into OPTEE.
  * 'cpu_ctx'        - space to maintain OPTEE architectural state
+ * 'ring_base'      - physical address of the request ring registered by the
+ *                    normal world for this cpu, if OPTEED_RING_DOORBELL
+ * 'ring_size'      - size of the request ring, 0 if none is registered
+ * 'fiq_ctx'        - context OPTEE handles S-EL1 FIQs in, if
+ *                    OPTEED_ROUTE_IRQ_TO_EL3. Switching to it leaves
+ *                    'cpu_ctx' untouched, so the state of a preempted
+ *                    standard call need not be copied aside and back.
+ * 'pm_ctx'         - copy of 'cpu_ctx' holding a standard call preempted on
+ *                    this cpu while OPTEE is entered to suspend and resume,
+ *                    if OPTEED_ROUTE_IRQ_TO_EL3
  ******************************************************************************/
 typedef struct optee_context {
 	uint32_t state;
 	uint64_t mpidr;
 	uint64_t c_rt_ctx;
 	cpu_context_t cpu_ctx;
+#if OPTEED_RING_DOORBELL
+	uint64_t ring_base;
+	uint64_t ring_size;
+#endif
+#if OPTEED_ROUTE_IRQ_TO_EL3
+	cpu_context_t fiq_ctx;
+	cpu_context_t pm_ctx;
+#endif
 } optee_context_t;
 
 /* OPTEED power management handlers */
@@ -168,6 +220,14 @@ uint64_t opteed_enter_sp(uint64_t *c_rt_ctx);
 void __dead2 opteed_exit_sp(uint64_t c_rt_ctx, uint64_t ret);
 uint64_t opteed_synchronous_sp_entry(optee_context_t *optee_ctx);
 void __dead2 opteed_synchronous_sp_exit(optee_context_t *optee_ctx, uint64_t ret);
+void opteed_complete_pm_entry(optee_context_t *optee_ctx);
+#if OPTEED_ROUTE_IRQ_TO_EL3
+uint32_t opteed_masked_spsr(void);
+#endif
+#if OPTEED_FAST_SMC_NO_EL1_SWAP
+void opteed_fast_el1_regs_enter(optee_context_t *optee_ctx);
+void opteed_fast_el1_regs_exit(void);
+#endif
 void opteed_init_optee_ep_state(struct entry_point_info *optee_ep,
 				uint32_t rw, uint64_t pc,
 				uint64_t paged_part, uint64_t mem_limit,
@@ -176,6 +236,7 @@ void opteed_init_optee_ep_state(struct entry_point_info *optee_ep,
 extern optee_context_t opteed_sp_context[OPTEED_CORE_COUNT];
 extern uint32_t opteed_rw;
 extern struct optee_vectors *optee_vectors;
+extern uint32_t optee_caps;
 #endif /*__ASSEMBLY__*/
 
 #endif /* __OPTEED_PRIVATE_H__ */
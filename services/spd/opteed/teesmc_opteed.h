@@ -51,11 +51,29 @@
  * Register usage:
  * r0/x0	SMC Function ID, TEESMC_OPTEED_RETURN_ENTRY_DONE
  * r1/x1	Pointer to entry vector
+ * r2/x2	Capabilities of OP-TEE, TEESMC_OPTEED_CAP_*. Only looked at
+ *		when the dispatcher is built with OPTEED_FAST_SMC_NO_EL1_SWAP
  */
 #define TEESMC_OPTEED_FUNCID_RETURN_ENTRY_DONE		0
 #define TEESMC_OPTEED_RETURN_ENTRY_DONE \
 	TEESMC_OPTEED_RV(TEESMC_OPTEED_FUNCID_RETURN_ENTRY_DONE)
 
+/*
+ * OP-TEE serves fast calls without the full set of secure EL1 system
+ * registers.
+ *
+ * The dispatcher enters the "fast_smc" vector and returns to normal world
+ * from TEESMC_OPTEED_RETURN_CALL_DONE switching only SCTLR_EL1, TTBR0_EL1,
+ * TTBR1_EL1, TCR_EL1, MAIR_EL1, VBAR_EL1, SP_EL1, ESR_EL1, ELR_EL1,
+ * SPSR_EL1, FAR_EL1, TPIDR_EL1, CPACR_EL1 and CONTEXTIDR_EL1, which are
+ * loaded with the values OP-TEE last ran with. Changes to them are not kept
+ * for the next call. The fast call handlers run with the normal world values
+ * of the other EL1 system registers in place. They must not depend on the
+ * value of these other registers and must not modify them. Standard calls and
+ * the other vectors are not affected.
+ */
+#define TEESMC_OPTEED_CAP_FAST_NO_EL1_SWAP		(1 << 0)
+
 
 
 /*
@@ -144,4 +162,80 @@
 #define TEESMC_OPTEED_RETURN_SYSTEM_RESET_DONE \
 	TEESMC_OPTEED_RV(TEESMC_OPTEED_FUNCID_RETURN_SYSTEM_RESET_DONE)
 
+/*
+ * The following SMC Function IDs are issued by the normal world and are
+ * handled by the OP-TEE Dispatcher itself when the build option they depend
+ * on is enabled. They carry the same owner number as the return IDs above.
+ */
+#define TEESMC_OPTEED_CALL(type, cc, func_num) \
+		(((type) << FUNCID_TYPE_SHIFT) | \
+		 ((cc) << FUNCID_CC_SHIFT) | \
+		 (62 << FUNCID_OEN_SHIFT) | \
+		 ((func_num) & FUNCID_NUM_MASK))
+
+#if OPTEED_RING_DOORBELL
+
+/*
+ * Registers a request ring in normal world memory for the calling cpu. A
+ * size of 0 removes the registration. The ring is forgotten when the cpu is
+ * turned off.
+ *
+ * Register usage:
+ * x0		SMC Function ID, TEESMC_OPTEED_RING_REGISTER
+ * x1		Physical address of the ring, page aligned
+ * x2		Size of the ring in bytes, a multiple of the page size
+ *
+ * Returns 0 in x0 on success or SMC_UNK if the ring is rejected
+ */
+#define TEESMC_OPTEED_FUNCID_RING_REGISTER		16
+#define TEESMC_OPTEED_RING_REGISTER \
+	TEESMC_OPTEED_CALL(SMC_TYPE_FAST, SMC_64, \
+			   TEESMC_OPTEED_FUNCID_RING_REGISTER)
+
+/*
+ * Tells OP-TEE that requests have been posted in the ring of the calling
+ * cpu. The call is delivered through the "std_smc" vector with the ring
+ * described in the registers, so that all the posted requests are served
+ * and their completions written back to the ring in a single world switch.
+ * The layout of the ring is a contract between OP-TEE and its normal world
+ * driver and is not interpreted by the dispatcher.
+ *
+ * Register usage from the normal world:
+ * r0/x0	SMC Function ID, TEESMC_OPTEED_RING_DOORBELL
+ * r1/x1	Number of posted requests, as a hint
+ *
+ * Register usage on entry in the "std_smc" vector:
+ * r0/x0	SMC Function ID, TEESMC_OPTEED_RING_DOORBELL
+ * r1/x1	Physical address of the ring
+ * r2/x2	Size of the ring in bytes
+ * r3/x3	Number of posted requests, as a hint
+ *
+ * OP-TEE returns with TEESMC_OPTEED_RETURN_CALL_DONE as for any other call.
+ * SMC_UNK is returned to the normal world if no ring is registered.
+ */
+#define TEESMC_OPTEED_FUNCID_RING_DOORBELL		17
+#define TEESMC_OPTEED_RING_DOORBELL \
+	TEESMC_OPTEED_CALL(SMC_TYPE_STD, SMC_32, \
+			   TEESMC_OPTEED_FUNCID_RING_DOORBELL)
+#endif /* OPTEED_RING_DOORBELL */
+
+#if OPTEED_ROUTE_IRQ_TO_EL3
+/*
+ * Resumes the standard call which was preempted on the calling cpu. A
+ * standard call is preempted when a normal world interrupt is taken while
+ * OP-TEE runs it. The normal world then gets SMC_PREEMPTED in x0 instead of
+ * the result of the call, handles the interrupt and issues this call, which
+ * returns the result of the preempted call or SMC_PREEMPTED again. Other
+ * calls return SMC_UNK while a standard call is in progress on the cpu.
+ *
+ * Register usage:
+ * r0/x0	SMC Function ID, TEESMC_OPTEED_RESUME
+ *
+ * SMC_UNK is returned if no call is preempted on the calling cpu.
+ */
+#define TEESMC_OPTEED_FUNCID_RESUME			18
+#define TEESMC_OPTEED_RESUME \
+	TEESMC_OPTEED_CALL(SMC_TYPE_STD, SMC_32, TEESMC_OPTEED_FUNCID_RESUME)
+#endif /* OPTEED_ROUTE_IRQ_TO_EL3 */
+
 #endif /*TEESMC_OPTEED_H*/
@@ -59,3 +59,50 @@ TSPD_ROUTE_IRQ_TO_EL3	:=	0
 
 $(eval $(call assert_boolean,TSPD_ROUTE_IRQ_TO_EL3))
 $(eval $(call add_define,TSPD_ROUTE_IRQ_TO_EL3))
+
+# Number of contexts in which the TSP can run standard SMCs on a cpu at the
+# same time. A new standard SMC is accepted while earlier ones are preempted
+# as long as a context is free.
+TSPD_NUM_STD_CTX	:=	1
+
+ifeq ($(filter 1 2 3 4 5 6 7 8,${TSPD_NUM_STD_CTX}),)
+  $(error TSPD_NUM_STD_CTX must be between 1 and 8)
+endif
+$(eval $(call add_define,TSPD_NUM_STD_CTX))
+
+# Flag used to hand the standard SMCs issued on the other cpus over to the TSP
+# on the worker cpu, whose linear index is TSPD_WORKER_CORE_POS. The worker cpu
+# is woken up with the TSP_IRQ_WORKER_SGI secure SGI.
+TSPD_STD_SMC_WORKER	:=	0
+TSPD_WORKER_CORE_POS	:=	1
+
+$(eval $(call assert_boolean,TSPD_STD_SMC_WORKER))
+$(eval $(call add_define,TSPD_STD_SMC_WORKER))
+$(eval $(call add_define,TSPD_WORKER_CORE_POS))
+
+ifeq (${TSPD_STD_SMC_WORKER},1)
+  ifeq (${TSPD_NUM_STD_CTX},1)
+    $(error TSPD_STD_SMC_WORKER requires TSPD_NUM_STD_CTX to be greater than 1)
+  endif
+SPD_SOURCES		+=	services/spd/tspd/tspd_worker.c
+endif
+
+# Flag used to keep per-cpu counts of the standard and fast SMCs, preemptions,
+# resumptions and S-EL1 FIQ round trips seen by the TSPD, and of the time spent
+# in the secure world. They are read with the TSP_FID_STATS SMC.
+TSPD_STATS		:=	0
+
+$(eval $(call assert_boolean,TSPD_STATS))
+$(eval $(call add_define,TSPD_STATS))
+
+ifeq (${TSPD_STATS},1)
+SPD_SOURCES		+=	services/spd/tspd/tspd_stats.c
+endif
+
+# Flag used to defer the entry into the TSP after a cpu has been turned on or
+# resumed until the first secure call or S-EL1 interrupt on that cpu, instead
+# of doing it in the PSCI power management hooks.
+TSPD_LAZY_CPU_INIT	:=	0
+
+$(eval $(call assert_boolean,TSPD_LAZY_CPU_INIT))
+$(eval $(call add_define,TSPD_LAZY_CPU_INIT))
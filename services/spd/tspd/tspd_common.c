@@ -63,6 +63,8 @@ void tspd_init_tsp_ep_state(struct entry_point_info *tsp_entry_point,
 	tsp_ctx->state = 0;
 	set_tsp_pstate(tsp_ctx->state, TSP_PSTATE_OFF);
 	clr_std_smc_active_flag(tsp_ctx->state);
+	tsp_ctx->std_ctx_idx = 0;
+	tsp_ctx->std_ctx_active = 0;
 
 	cm_set_context(&tsp_ctx->cpu_ctx, SECURE);
 
@@ -99,6 +101,7 @@ uint64_t tspd_synchronous_sp_entry(tsp_context_t *tsp_ctx)
 	cm_el1_sysregs_context_restore(SECURE);
 	cm_set_next_eret_context(SECURE);
 
+	tspd_stats_sp_entry();
 	rc = tspd_enter_sp(&tsp_ctx->c_rt_ctx);
 #if DEBUG
 	tsp_ctx->c_rt_ctx = 0;
@@ -123,9 +126,72 @@ void tspd_synchronous_sp_exit(tsp_context_t *tsp_ctx, uint64_t ret)
 	assert(cm_get_context(SECURE) == &tsp_ctx->cpu_ctx);
 	cm_el1_sysregs_context_save(SECURE);
 
+	tspd_stats_sp_exit();
+
 	assert(tsp_ctx->c_rt_ctx != 0);
 	tspd_exit_sp(tsp_ctx->c_rt_ctx, ret);
 
 	/* Should never reach here */
 	assert(0);
 }
+
+/*******************************************************************************
+ * This function returns the index of a standard SMC context in which no
+ * standard SMC is in progress, preferring 'cpu_ctx', or -1 if the SP has been
+ * preempted in all of them.
+ ******************************************************************************/
+int32_t tspd_get_free_std_ctx(tsp_context_t *tsp_ctx)
+{
+	int32_t idx;
+
+	for (idx = 0; idx < TSPD_NUM_STD_CTX; idx++) {
+		if (!(tsp_ctx->std_ctx_active & (1 << idx)))
+			return idx;
+	}
+
+	return -1;
+}
+
+/*******************************************************************************
+ * This function makes the standard SMC context 'idx' the secure context of
+ * this cpu. An additional context in which no standard SMC is in progress is
+ * first initialised from 'cpu_ctx', so that the SP runs with the same system
+ * register state. The SP is expected to switch to a stack of its own for each
+ * context. 'cpu_ctx' must be selected again before returning to the normal
+ * world.
+ ******************************************************************************/
+void tspd_select_std_ctx(tsp_context_t *tsp_ctx, uint32_t idx)
+{
+	cpu_context_t *ctx = &tsp_ctx->cpu_ctx;
+
+	assert(idx < TSPD_NUM_STD_CTX);
+
+#if TSPD_NUM_STD_CTX > 1
+	if (idx) {
+		ctx = &tsp_ctx->std_ctx[idx - 1];
+		if (!(tsp_ctx->std_ctx_active & (1 << idx)))
+			memcpy(ctx, &tsp_ctx->cpu_ctx, sizeof(*ctx));
+	}
+#endif
+
+	cm_set_context(ctx, SECURE);
+	tsp_ctx->std_ctx_idx = idx;
+}
+
+/*******************************************************************************
+ * These functions track the standard SMC in progress in the current standard
+ * SMC context. The STD_SMC_ACTIVE flag is set as long as one is in progress in
+ * any context.
+ ******************************************************************************/
+void tspd_set_std_smc_active(tsp_context_t *tsp_ctx)
+{
+	tsp_ctx->std_ctx_active |= 1 << tsp_ctx->std_ctx_idx;
+	set_std_smc_active_flag(tsp_ctx->state);
+}
+
+void tspd_clr_std_smc_active(tsp_context_t *tsp_ctx)
+{
+	tsp_ctx->std_ctx_active &= ~(1 << tsp_ctx->std_ctx_idx);
+	if (!tsp_ctx->std_ctx_active)
+		clr_std_smc_active_flag(tsp_ctx->state);
+}
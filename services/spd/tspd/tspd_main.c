@@ -48,7 +48,6 @@
 #include <platform.h>
 #include <runtime_svc.h>
 #include <stddef.h>
-#include <string.h>
 #include <tsp.h>
 #include <uuid.h>
 #include "tspd_private.h"
@@ -75,8 +74,15 @@ int32_t tspd_init(void);
 uint64_t tspd_handle_sp_preemption(void *handle)
 {
 	cpu_context_t *ns_cpu_context;
+	uint64_t mpidr = read_mpidr();
+	uint32_t linear_id = platform_get_core_pos(mpidr);
+	tsp_context_t *tsp_ctx = &tspd_sp_context[linear_id];
+	uint32_t idx = tsp_ctx->std_ctx_idx;
+
 	assert(handle == cm_get_context(SECURE));
 	cm_el1_sysregs_context_save(SECURE);
+	tspd_select_std_ctx(tsp_ctx, 0);
+
 	/* Get a reference to the non-secure context */
 	ns_cpu_context = cm_get_context(NON_SECURE);
 	assert(ns_cpu_context);
@@ -88,7 +94,22 @@ uint64_t tspd_handle_sp_preemption(void *handle)
 	cm_el1_sysregs_context_restore(NON_SECURE);
 	cm_set_next_eret_context(NON_SECURE);
 
-	SMC_RET1(ns_cpu_context, SMC_PREEMPTED);
+	tspd_stats_count(TSPD_STATS_PREEMPT);
+	tspd_stats_sp_exit();
+
+#if TSPD_STD_SMC_WORKER
+	/*
+	 * The normal world did not issue a request handed over to this cpu
+	 * by another one, so it simply resumes where it was interrupted.
+	 */
+	if (tspd_worker_owns_ctx(tsp_ctx, idx)) {
+		tspd_worker_preempted();
+		SMC_RET0(ns_cpu_context);
+	}
+#endif
+
+	/* Tell the normal world which context to resume */
+	SMC_RET2(ns_cpu_context, SMC_PREEMPTED, idx);
 }
 /*******************************************************************************
  * This function is the handler registered for S-EL1 interrupts by the TSPD. It
@@ -124,33 +145,38 @@ static uint64_t tspd_sel1_interrupt_handler(uint32_t id,
 	tsp_ctx = &tspd_sp_context[linear_id];
 	assert(&tsp_ctx->cpu_ctx == cm_get_context(SECURE));
 
+#if TSPD_LAZY_CPU_INIT
+	/* Let the TSP initialise or resume itself on this cpu first */
+	tspd_complete_pm_entry(tsp_ctx);
+#endif
+
 	/*
-	 * Determine if the TSP was previously preempted. Its last known
-	 * context has to be preserved in this case.
 	 * The TSP should return control to the TSPD after handling this
-	 * FIQ. Preserve essential EL3 context to allow entry into the
-	 * TSP at the FIQ entry point using the 'cpu_context' structure.
-	 * There is no need to save the secure system register context
-	 * since the TSP is supposed to preserve it during S-EL1 interrupt
-	 * handling.
+	 * FIQ. Enter it at the FIQ entry point through 'fiq_ctx' so that
+	 * 'cpu_ctx', which holds the last known state of a TSP preempted
+	 * during a standard SMC, is preserved without being copied. The
+	 * S-EL1 system registers are restored from 'cpu_ctx' before the
+	 * switch and need not be saved afterwards since the TSP is supposed
+	 * to preserve them during S-EL1 interrupt handling. Only the
+	 * SCR_EL3 has to be carried over for el3_exit().
 	 */
-	if (get_std_smc_active_flag(tsp_ctx->state)) {
-		tsp_ctx->saved_spsr_el3 = SMC_GET_EL3(&tsp_ctx->cpu_ctx,
-						      CTX_SPSR_EL3);
-		tsp_ctx->saved_elr_el3 = SMC_GET_EL3(&tsp_ctx->cpu_ctx,
-						     CTX_ELR_EL3);
-#if TSPD_ROUTE_IRQ_TO_EL3
-		/*Need to save the previously interrupted secure context */
-		memcpy(&tsp_ctx->sp_ctx, &tsp_ctx->cpu_ctx, TSPD_SP_CTX_SIZE);
-#endif
-	}
-
 	cm_el1_sysregs_context_restore(SECURE);
+	write_ctx_reg(get_el3state_ctx(&tsp_ctx->fiq_ctx), CTX_SCR_EL3,
+		read_ctx_reg(get_el3state_ctx(&tsp_ctx->cpu_ctx), CTX_SCR_EL3));
+	cm_set_context(&tsp_ctx->fiq_ctx, SECURE);
+
 	cm_set_elr_spsr_el3(SECURE, (uint64_t) &tsp_vectors->fiq_entry,
 		    SPSR_64(MODE_EL1, MODE_SP_ELX, DISABLE_ALL_EXCEPTIONS));
 
 	cm_set_next_eret_context(SECURE);
 
+#if INTR_LATENCY_STATS
+	/* Account the time taken to hand over the interrupt to S-EL1 */
+	intr_lat_stats_mark_handoff();
+#endif
+
+	tspd_stats_sp_entry();
+
 	/*
 	 * Tell the TSP that it has to handle an FIQ synchronously. Also the
 	 * instruction in normal world where the interrupt was generated is
@@ -158,7 +184,7 @@ static uint64_t tspd_sel1_interrupt_handler(uint32_t id,
 	 * from ELR_EL3 as the secure context will not take effect until
 	 * el3_exit().
 	 */
-	SMC_RET2(&tsp_ctx->cpu_ctx, TSP_HANDLE_FIQ_AND_RETURN, read_elr_el3());
+	SMC_RET2(&tsp_ctx->fiq_ctx, TSP_HANDLE_FIQ_AND_RETURN, read_elr_el3());
 }
 
 #if TSPD_ROUTE_IRQ_TO_EL3
@@ -304,6 +330,14 @@ uint64_t tspd_smc_handler(uint32_t smc_fid,
 	uint32_t linear_id = platform_get_core_pos(mpidr), ns;
 	tsp_context_t *tsp_ctx = &tspd_sp_context[linear_id];
 	uint64_t rc;
+	int32_t idx;
+#if TSPD_STD_SMC_WORKER
+	uint64_t worker_rets[TSPD_WORKER_NUM_RETS];
+	int32_t ret;
+#endif
+#if TSPD_STATS
+	uint64_t stats_rets[TSPD_STATS_NUM_RETS];
+#endif
 #if TSP_INIT_ASYNC
 	entry_point_info_t *next_image_info;
 #endif
@@ -335,26 +369,28 @@ uint64_t tspd_smc_handler(uint32_t smc_fid,
 
 		assert(handle == cm_get_context(SECURE));
 
+#if INTR_LATENCY_STATS
+		/* Account the time taken by the TSP to handle the FIQ */
+		intr_lat_stats_mark_return();
+#endif
+
 		/*
-		 * Restore the relevant EL3 state which saved to service
-		 * this SMC.
+		 * Switch back to the context in which the TSP was running
+		 * before the FIQ was taken. It was left untouched.
 		 */
-		if (get_std_smc_active_flag(tsp_ctx->state)) {
-			SMC_SET_EL3(&tsp_ctx->cpu_ctx,
-				    CTX_SPSR_EL3,
-				    tsp_ctx->saved_spsr_el3);
-			SMC_SET_EL3(&tsp_ctx->cpu_ctx,
-				    CTX_ELR_EL3,
-				    tsp_ctx->saved_elr_el3);
-#if TSPD_ROUTE_IRQ_TO_EL3
-			/*
-			 * Need to restore the previously interrupted
-			 * secure context.
-			 */
-			memcpy(&tsp_ctx->cpu_ctx, &tsp_ctx->sp_ctx,
-				TSPD_SP_CTX_SIZE);
+		assert(handle == &tsp_ctx->fiq_ctx);
+		cm_set_context(&tsp_ctx->cpu_ctx, SECURE);
+
+#if TSPD_STD_SMC_WORKER
+		/*
+		 * The worker cpu runs the requests handed over by other cpus
+		 * before returning to the normal world. The non-secure context
+		 * has already been saved.
+		 */
+		if (linear_id == TSPD_WORKER_CORE_POS &&
+		    tspd_worker_run(tsp_ctx))
+			SMC_RET0(cm_get_context(SECURE));
 #endif
-		}
 
 		/* Get a reference to the non-secure context */
 		ns_cpu_context = cm_get_context(NON_SECURE);
@@ -368,6 +404,9 @@ uint64_t tspd_smc_handler(uint32_t smc_fid,
 		cm_el1_sysregs_context_restore(NON_SECURE);
 		cm_set_next_eret_context(NON_SECURE);
 
+		tspd_stats_count(TSPD_STATS_FIQ);
+		tspd_stats_sp_exit();
+
 		SMC_RET0((uint64_t) ns_cpu_context);
 
 
@@ -387,6 +426,8 @@ uint64_t tspd_smc_handler(uint32_t smc_fid,
 
 		/* Save the secure system register state */
 		cm_el1_sysregs_context_save(SECURE);
+		idx = tsp_ctx->std_ctx_idx;
+		tspd_select_std_ctx(tsp_ctx, 0);
 
 		/* Get a reference to the non-secure context */
 		ns_cpu_context = cm_get_context(NON_SECURE);
@@ -396,7 +437,18 @@ uint64_t tspd_smc_handler(uint32_t smc_fid,
 		cm_el1_sysregs_context_restore(NON_SECURE);
 		cm_set_next_eret_context(NON_SECURE);
 
-		SMC_RET1(ns_cpu_context, TSP_EL3_FIQ);
+		tspd_stats_count(TSPD_STATS_EL3_FIQ);
+		tspd_stats_sp_exit();
+
+#if TSPD_STD_SMC_WORKER
+		/* The EL3 FIQ is taken as soon as the normal world resumes */
+		if (tspd_worker_owns_ctx(tsp_ctx, idx)) {
+			tspd_worker_preempted();
+			SMC_RET0(ns_cpu_context);
+		}
+#endif
+
+		SMC_RET2(ns_cpu_context, TSP_EL3_FIQ, idx);
 
 
 	/*
@@ -520,18 +572,20 @@ uint64_t tspd_smc_handler(uint32_t smc_fid,
 
 		/*
 		 * Request from non-secure client to perform an
-		 * arithmetic operation or response from secure
-		 * payload to an earlier request.
+		 * arithmetic or benchmark operation or response from
+		 * secure payload to an earlier request.
 		 */
 	case TSP_FAST_FID(TSP_ADD):
 	case TSP_FAST_FID(TSP_SUB):
 	case TSP_FAST_FID(TSP_MUL):
 	case TSP_FAST_FID(TSP_DIV):
+	case TSP_FAST_FID(TSP_BENCH):
 
 	case TSP_STD_FID(TSP_ADD):
 	case TSP_STD_FID(TSP_SUB):
 	case TSP_STD_FID(TSP_MUL):
 	case TSP_STD_FID(TSP_DIV):
+	case TSP_STD_FID(TSP_BENCH):
 		if (ns) {
 			/*
 			 * This is a fresh request from the non-secure client.
@@ -541,11 +595,38 @@ uint64_t tspd_smc_handler(uint32_t smc_fid,
 			 */
 			assert(handle == cm_get_context(NON_SECURE));
 
-			/* Check if we are already preempted */
-			if (get_std_smc_active_flag(tsp_ctx->state))
+#if TSPD_STD_SMC_WORKER
+			/*
+			 * Hand a standard SMC over to the worker cpu if
+			 * possible. The caller is told that it has been
+			 * preempted and polls for its completion through
+			 * TSP_FID_RESUME.
+			 */
+			if (GET_SMC_TYPE(smc_fid) == SMC_TYPE_STD) {
+				ret = tspd_worker_queue(linear_id, smc_fid,
+							x1, x2);
+				if (ret == 0)
+					SMC_RET2(handle, SMC_PREEMPTED,
+						 TSPD_WORKER_CTX);
+				if (ret == -EBUSY)
+					SMC_RET1(handle, SMC_UNK);
+			}
+#endif
+
+			/*
+			 * Pick a context in which the TSP has not been
+			 * preempted. The request is rejected if there is none.
+			 */
+			idx = tspd_get_free_std_ctx(tsp_ctx);
+			if (idx < 0)
 				SMC_RET1(handle, SMC_UNK);
 
 			cm_el1_sysregs_context_save(NON_SECURE);
+#if TSPD_LAZY_CPU_INIT
+			/* Let the TSP initialise or resume itself first */
+			tspd_complete_pm_entry(tsp_ctx);
+#endif
+			tspd_select_std_ctx(tsp_ctx, idx);
 
 			/* Save x1 and x2 for use by TSP_GET_ARGS call below */
 			store_tsp_args(tsp_ctx, x1, x2);
@@ -562,7 +643,7 @@ uint64_t tspd_smc_handler(uint32_t smc_fid,
 			 * payload. Entry into S-EL1 will take place upon exit
 			 * from this function.
 			 */
-			assert(&tsp_ctx->cpu_ctx == cm_get_context(SECURE));
+			assert(cm_get_context(SECURE));
 
 			/* Set appropriate entry for SMC.
 			 * We expect the TSP to manage the PSTATE.I and PSTATE.F
@@ -572,7 +653,7 @@ uint64_t tspd_smc_handler(uint32_t smc_fid,
 				cm_set_elr_el3(SECURE, (uint64_t)
 						&tsp_vectors->fast_smc_entry);
 			} else {
-				set_std_smc_active_flag(tsp_ctx->state);
+				tspd_set_std_smc_active(tsp_ctx);
 				cm_set_elr_el3(SECURE, (uint64_t)
 						&tsp_vectors->std_smc_entry);
 #if TSPD_ROUTE_IRQ_TO_EL3
@@ -586,16 +667,27 @@ uint64_t tspd_smc_handler(uint32_t smc_fid,
 
 			cm_el1_sysregs_context_restore(SECURE);
 			cm_set_next_eret_context(SECURE);
-			SMC_RET3(&tsp_ctx->cpu_ctx, smc_fid, x1, x2);
+
+			tspd_stats_count(GET_SMC_TYPE(smc_fid) == SMC_TYPE_FAST ?
+					 TSPD_STATS_FAST_SMC :
+					 TSPD_STATS_STD_SMC);
+			tspd_stats_sp_entry();
+
+			/* The TSP runs the request on the stack of context x3 */
+			SMC_RET4(cm_get_context(SECURE), smc_fid, x1, x2, idx);
 		} else {
 			/*
 			 * This is the result from the secure client of an
-			 * earlier request. The results are in x1-x3. Copy it
+			 * earlier request. The results are in x1-x4. Copy it
 			 * into the non-secure context, save the secure state
 			 * and return to the non-secure state.
 			 */
 			assert(handle == cm_get_context(SECURE));
 			cm_el1_sysregs_context_save(SECURE);
+			idx = tsp_ctx->std_ctx_idx;
+			if (GET_SMC_TYPE(smc_fid) == SMC_TYPE_STD)
+				tspd_clr_std_smc_active(tsp_ctx);
+			tspd_select_std_ctx(tsp_ctx, 0);
 
 			/* Get a reference to the non-secure context */
 			ns_cpu_context = cm_get_context(NON_SECURE);
@@ -604,8 +696,8 @@ uint64_t tspd_smc_handler(uint32_t smc_fid,
 			/* Restore non-secure state */
 			cm_el1_sysregs_context_restore(NON_SECURE);
 			cm_set_next_eret_context(NON_SECURE);
+			tspd_stats_sp_exit();
 			if (GET_SMC_TYPE(smc_fid) == SMC_TYPE_STD) {
-				clr_std_smc_active_flag(tsp_ctx->state);
 #if TSPD_ROUTE_IRQ_TO_EL3
 				/*
 				 * Disable the routing of NS interrupts to EL3
@@ -613,10 +705,23 @@ uint64_t tspd_smc_handler(uint32_t smc_fid,
 				 * core.
 				 */
 				disable_intr_rm_local(INTR_TYPE_NS, SECURE);
+#endif
+#if TSPD_STD_SMC_WORKER
+				/*
+				 * Keep the results of a request handed over by
+				 * another cpu for it to collect.
+				 */
+				if (tspd_worker_owns_ctx(tsp_ctx, idx)) {
+					tspd_worker_done(x1, x2, x3, x4);
+					SMC_RET0(ns_cpu_context);
+				}
+
+				if (linear_id == TSPD_WORKER_CORE_POS)
+					tspd_worker_ctx_freed();
 #endif
 			}
 
-			SMC_RET3(ns_cpu_context, x1, x2, x3);
+			SMC_RET4(ns_cpu_context, x1, x2, x3, x4);
 		}
 
 		break;
@@ -639,11 +744,41 @@ uint64_t tspd_smc_handler(uint32_t smc_fid,
 		 */
 		assert(handle == cm_get_context(NON_SECURE));
 
-		/* Check if we are already preempted before resume */
-		if (!get_std_smc_active_flag(tsp_ctx->state))
+#if TSPD_STD_SMC_WORKER
+		/*
+		 * A cpu which has handed a request over to the worker cpu
+		 * polls for its results.
+		 */
+		ret = tspd_worker_poll(linear_id, worker_rets);
+		if (ret == 0)
+			SMC_RET4(handle, worker_rets[0], worker_rets[1],
+				 worker_rets[2], worker_rets[3]);
+		if (ret == -EINPROGRESS)
+			SMC_RET2(handle, SMC_PREEMPTED, TSPD_WORKER_CTX);
+#endif
+
+		/*
+		 * Check if we are already preempted before resume. The
+		 * context to resume is passed in x1 if there are several.
+		 */
+		if (TSPD_NUM_STD_CTX == 1)
+			x1 = 0;
+		if (x1 >= TSPD_NUM_STD_CTX ||
+		    !(tsp_ctx->std_ctx_active & (1 << x1)))
 			SMC_RET1(handle, SMC_UNK);
 
+#if TSPD_STD_SMC_WORKER
+		/* The worker cpu may be preempted in a request of another */
+		if (tspd_worker_owns_ctx(tsp_ctx, x1))
+			SMC_RET1(handle, SMC_UNK);
+#endif
+
 		cm_el1_sysregs_context_save(NON_SECURE);
+#if TSPD_LAZY_CPU_INIT
+		/* The TSP may have been suspended since it was preempted */
+		tspd_complete_pm_entry(tsp_ctx);
+#endif
+		tspd_select_std_ctx(tsp_ctx, x1);
 
 		/*
 		 * We are done stashing the non-secure context. Ask the
@@ -664,7 +799,9 @@ uint64_t tspd_smc_handler(uint32_t smc_fid,
 		 */
 		cm_el1_sysregs_context_restore(SECURE);
 		cm_set_next_eret_context(SECURE);
-		SMC_RET0(&tsp_ctx->cpu_ctx);
+		tspd_stats_count(TSPD_STATS_RESUME);
+		tspd_stats_sp_entry();
+		SMC_RET0(cm_get_context(SECURE));
 
 		/*
 		 * This is a request from the secure payload for more arguments
@@ -679,12 +816,24 @@ uint64_t tspd_smc_handler(uint32_t smc_fid,
 		get_tsp_args(tsp_ctx, x1, x2);
 		SMC_RET2(handle, x1, x2);
 
+#if TSPD_STATS
+	case TSP_FID_STATS:
+		if (!ns)
+			SMC_RET1(handle, SMC_UNK);
+
+		if (tspd_stats_get(x1, x2, stats_rets))
+			SMC_RET1(handle, SMC_UNK);
+
+		SMC_RET4(handle, 0, stats_rets[0], stats_rets[1],
+			 stats_rets[2]);
+#endif
+
 	case TOS_CALL_COUNT:
 		/*
 		 * Return the number of service function IDs implemented to
 		 * provide service to non-secure
 		 */
-		SMC_RET1(handle, TSP_NUM_FID);
+		SMC_RET1(handle, TSP_NUM_FID + TSPD_STATS);
 
 	case TOS_UID:
 		/* Return TSP UID to the caller */
@@ -57,6 +57,20 @@ static int32_t tspd_cpu_off_handler(uint64_t unused)
 	tsp_context_t *tsp_ctx = &tspd_sp_context[linear_id];
 
 	assert(tsp_vectors);
+
+#if TSPD_STD_SMC_WORKER
+	/*
+	 * Refuse to turn the worker cpu off while the TSP is preempted in a
+	 * request handed over by another cpu, which would be lost.
+	 */
+	if (linear_id == TSPD_WORKER_CORE_POS && tspd_worker_holds_req())
+		return PSCI_E_DENIED;
+#endif
+
+#if TSPD_LAZY_CPU_INIT
+	/* Complete a deferred cpu_on or cpu_resume entry first */
+	tspd_complete_pm_entry(tsp_ctx);
+#endif
 	assert(get_tsp_pstate(tsp_ctx->state) == TSP_PSTATE_ON);
 
 	/* Program the entry point and enter the TSP */
@@ -76,6 +90,12 @@ static int32_t tspd_cpu_off_handler(uint64_t unused)
 	 */
 	set_tsp_pstate(tsp_ctx->state, TSP_PSTATE_OFF);
 
+#if TSPD_STD_SMC_WORKER
+	/* Fail the requests queued for this cpu by the others */
+	if (linear_id == TSPD_WORKER_CORE_POS)
+		tspd_worker_flush();
+#endif
+
 	 return 0;
 }
 
@@ -91,6 +111,15 @@ static void tspd_cpu_suspend_handler(uint64_t unused)
 	tsp_context_t *tsp_ctx = &tspd_sp_context[linear_id];
 
 	assert(tsp_vectors);
+
+	/*
+	 * A TSP which has not been entered since this cpu was turned on or
+	 * resumed is left as it is.
+	 */
+	if (TSPD_LAZY_CPU_INIT &&
+	    get_tsp_pstate(tsp_ctx->state) != TSP_PSTATE_ON)
+		return;
+
 	assert(get_tsp_pstate(tsp_ctx->state) == TSP_PSTATE_ON);
 
 	/* Program the entry point and enter the TSP */
@@ -108,6 +137,45 @@ static void tspd_cpu_suspend_handler(uint64_t unused)
 	set_tsp_pstate(tsp_ctx->state, TSP_PSTATE_SUSPEND);
 }
 
+/*******************************************************************************
+ * This function enters the TSP on this cpu if it has been turned on or resumed
+ * since it was last entered, so that it initialises S-EL1 or does its resume
+ * book keeping. With TSPD_LAZY_CPU_INIT, this is done upon the first secure
+ * call on this cpu instead of in the power management handlers, so that the
+ * normal world does not wait for the TSP when it turns on or resumes a cpu.
+ ******************************************************************************/
+void tspd_complete_pm_entry(tsp_context_t *tsp_ctx)
+{
+	int32_t rc;
+
+	switch (get_tsp_pstate(tsp_ctx->state)) {
+	case TSP_PSTATE_ON:
+		return;
+	case TSP_PSTATE_ON_PENDING:
+		/* The context has been initialised to enter 'cpu_on_entry' */
+		break;
+	case TSP_PSTATE_SUSPEND:
+		/* The suspend level has been passed in x0 */
+		cm_set_elr_el3(SECURE,
+			       (uint64_t) &tsp_vectors->cpu_resume_entry);
+		break;
+	default:
+		panic();
+	}
+
+	rc = tspd_synchronous_sp_entry(tsp_ctx);
+
+	/*
+	 * Read the response from the TSP. A non-zero return means that
+	 * something went wrong while communicating with the TSP.
+	 */
+	if (rc != 0)
+		panic();
+
+	/* Update its context to reflect the state the TSP is in */
+	set_tsp_pstate(tsp_ctx->state, TSP_PSTATE_ON);
+}
+
 /*******************************************************************************
  * This cpu has been turned on. Enter the TSP to initialise S-EL1 and other bits
  * before passing control back to the Secure Monitor. Entry in S-El1 is done
@@ -116,7 +184,6 @@ static void tspd_cpu_suspend_handler(uint64_t unused)
  ******************************************************************************/
 static void tspd_cpu_on_finish_handler(uint64_t unused)
 {
-	int32_t rc = 0;
 	uint64_t mpidr = read_mpidr();
 	uint32_t linear_id = platform_get_core_pos(mpidr);
 	tsp_context_t *tsp_ctx = &tspd_sp_context[linear_id];
@@ -141,18 +208,10 @@ static void tspd_cpu_on_finish_handler(uint64_t unused)
 	disable_intr_rm_local(INTR_TYPE_NS, SECURE);
 #endif
 
-	/* Enter the TSP */
-	rc = tspd_synchronous_sp_entry(tsp_ctx);
-
-	/*
-	 * Read the response from the TSP. A non-zero return means that
-	 * something went wrong while communicating with the SP.
-	 */
-	if (rc != 0)
-		panic();
-
-	/* Update its context to reflect the state the SP is in */
-	set_tsp_pstate(tsp_ctx->state, TSP_PSTATE_ON);
+	/* Enter the TSP unless this is deferred to the first secure call */
+	set_tsp_pstate(tsp_ctx->state, TSP_PSTATE_ON_PENDING);
+	if (!TSPD_LAZY_CPU_INIT)
+		tspd_complete_pm_entry(tsp_ctx);
 }
 
 /*******************************************************************************
@@ -162,30 +221,28 @@ static void tspd_cpu_on_finish_handler(uint64_t unused)
  ******************************************************************************/
 static void tspd_cpu_suspend_finish_handler(uint64_t suspend_level)
 {
-	int32_t rc = 0;
 	uint64_t mpidr = read_mpidr();
 	uint32_t linear_id = platform_get_core_pos(mpidr);
 	tsp_context_t *tsp_ctx = &tspd_sp_context[linear_id];
 
 	assert(tsp_vectors);
+
+	/* A TSP which was left as it was when this cpu was turned on still is */
+	if (TSPD_LAZY_CPU_INIT &&
+	    get_tsp_pstate(tsp_ctx->state) == TSP_PSTATE_ON_PENDING)
+		return;
+
 	assert(get_tsp_pstate(tsp_ctx->state) == TSP_PSTATE_SUSPEND);
 
-	/* Program the entry point, suspend_level and enter the SP */
+	/*
+	 * Pass the suspend_level and enter the SP unless this is deferred to
+	 * the first secure call
+	 */
 	write_ctx_reg(get_gpregs_ctx(&tsp_ctx->cpu_ctx),
 		      CTX_GPREG_X0,
 		      suspend_level);
-	cm_set_elr_el3(SECURE, (uint64_t) &tsp_vectors->cpu_resume_entry);
-	rc = tspd_synchronous_sp_entry(tsp_ctx);
-
-	/*
-	 * Read the response from the TSP. A non-zero return means that
-	 * something went wrong while communicating with the TSP.
-	 */
-	if (rc != 0)
-		panic();
-
-	/* Update its context to reflect the state the SP is in */
-	set_tsp_pstate(tsp_ctx->state, TSP_PSTATE_ON);
+	if (!TSPD_LAZY_CPU_INIT)
+		tspd_complete_pm_entry(tsp_ctx);
 }
 
 /*******************************************************************************
@@ -208,6 +265,11 @@ static void tspd_system_off(void)
 	tsp_context_t *tsp_ctx = &tspd_sp_context[linear_id];
 
 	assert(tsp_vectors);
+
+#if TSPD_LAZY_CPU_INIT
+	/* Complete a deferred cpu_on or cpu_resume entry first */
+	tspd_complete_pm_entry(tsp_ctx);
+#endif
 	assert(get_tsp_pstate(tsp_ctx->state) == TSP_PSTATE_ON);
 
 	/* Program the entry point */
@@ -229,6 +291,11 @@ static void tspd_system_reset(void)
 	tsp_context_t *tsp_ctx = &tspd_sp_context[linear_id];
 
 	assert(tsp_vectors);
+
+#if TSPD_LAZY_CPU_INIT
+	/* Complete a deferred cpu_on or cpu_resume entry first */
+	tspd_complete_pm_entry(tsp_ctx);
+#endif
 	assert(get_tsp_pstate(tsp_ctx->state) == TSP_PSTATE_ON);
 
 	/* Program the entry point */
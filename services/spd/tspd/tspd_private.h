@@ -44,6 +44,7 @@
 #define TSP_PSTATE_OFF		0
 #define TSP_PSTATE_ON		1
 #define TSP_PSTATE_SUSPEND	2
+#define TSP_PSTATE_ON_PENDING	3	/* Turned on, not entered yet */
 #define TSP_PSTATE_SHIFT	0
 #define TSP_PSTATE_MASK	0x3
 #define get_tsp_pstate(state)	((state >> TSP_PSTATE_SHIFT) & TSP_PSTATE_MASK)
@@ -120,34 +121,6 @@
 #define TSPD_C_RT_CTX_SIZE		0x60
 #define TSPD_C_RT_CTX_ENTRIES		(TSPD_C_RT_CTX_SIZE >> DWORD_SHIFT)
 
-/*******************************************************************************
- * Constants that allow assembler code to preserve caller-saved registers of the
- * SP context while performing a TSP preemption.
- * Note: These offsets have to match with the offsets for the corresponding
- * registers in cpu_context as we are using memcpy to copy the values from
- * cpu_context to sp_ctx.
- ******************************************************************************/
-#define TSPD_SP_CTX_X0		0x0
-#define TSPD_SP_CTX_X1		0x8
-#define TSPD_SP_CTX_X2		0x10
-#define TSPD_SP_CTX_X3		0x18
-#define TSPD_SP_CTX_X4		0x20
-#define TSPD_SP_CTX_X5		0x28
-#define TSPD_SP_CTX_X6		0x30
-#define TSPD_SP_CTX_X7		0x38
-#define TSPD_SP_CTX_X8		0x40
-#define TSPD_SP_CTX_X9		0x48
-#define TSPD_SP_CTX_X10		0x50
-#define TSPD_SP_CTX_X11		0x58
-#define TSPD_SP_CTX_X12		0x60
-#define TSPD_SP_CTX_X13		0x68
-#define TSPD_SP_CTX_X14		0x70
-#define TSPD_SP_CTX_X15		0x78
-#define TSPD_SP_CTX_X16		0x80
-#define TSPD_SP_CTX_X17		0x88
-#define TSPD_SP_CTX_SIZE	0x90
-#define TSPD_SP_CTX_ENTRIES		(TSPD_SP_CTX_SIZE >> DWORD_SHIFT)
-
 #ifndef __ASSEMBLY__
 
 #include <cassert.h>
@@ -170,62 +143,76 @@ DEFINE_REG_STRUCT(c_rt_regs, TSPD_C_RT_CTX_ENTRIES);
 CASSERT(TSPD_C_RT_CTX_SIZE == sizeof(c_rt_regs_t),	\
 	assert_spd_c_rt_regs_size_mismatch);
 
-/* SEL1 Secure payload (SP) caller saved register context structure. */
-DEFINE_REG_STRUCT(sp_ctx_regs, TSPD_SP_CTX_ENTRIES);
-
-/*
- * Compile time assertion to ensure that both the compiler and linker
- * have the same double word aligned view of the size of the C runtime
- * register context.
- */
-CASSERT(TSPD_SP_CTX_SIZE == sizeof(sp_ctx_regs_t),	\
-	assert_spd_sp_regs_size_mismatch);
-
 /*******************************************************************************
  * Structure which helps the SPD to maintain the per-cpu state of the SP.
- * 'saved_spsr_el3' - temporary copy to allow FIQ handling when the TSP has been
- *                    preempted.
- * 'saved_elr_el3'  - temporary copy to allow FIQ handling when the TSP has been
- *                    preempted.
  * 'state'          - collection of flags to track SP state e.g. on/off
  * 'mpidr'          - mpidr to associate a context with a cpu
  * 'c_rt_ctx'       - stack address to restore C runtime context from after
  *                    returning from a synchronous entry into the SP.
- * 'cpu_ctx'        - space to maintain SP architectural state
+ * 'cpu_ctx'        - space to maintain SP architectural state. It is the
+ *                    context used while the normal world runs.
  * 'saved_tsp_args' - space to store arguments for TSP arithmetic operations
- *                    which will queried using the TSP_GET_ARGS SMC by TSP.
- * 'sp_ctx'         - space to save the SEL1 Secure Payload(SP) caller saved
- *                    register context after it has been preempted by an EL3
- *                    routed NS interrupt and when a Secure Interrupt is taken
- *                    to SP.
+ *                    which will queried using the TSP_GET_ARGS SMC by TSP,
+ *                    for each standard SMC context.
+ * 'std_ctx_idx'    - index of the standard SMC context the SP runs in, 0 for
+ *                    'cpu_ctx'.
+ * 'std_ctx_active' - mask of the standard SMC contexts in which a standard
+ *                    SMC is in progress.
+ * 'std_ctx'        - additional contexts in which the SP can run requests
+ *                    while standard SMCs are preempted in the others.
+ * 'fiq_ctx'        - context the SP handles S-EL1 FIQs in. Switching to it
+ *                    leaves 'cpu_ctx' untouched, so the state of a preempted
+ *                    standard SMC need not be copied aside and back.
  ******************************************************************************/
 typedef struct tsp_context {
-	uint64_t saved_elr_el3;
-	uint32_t saved_spsr_el3;
 	uint32_t state;
 	uint64_t mpidr;
 	uint64_t c_rt_ctx;
 	cpu_context_t cpu_ctx;
-	uint64_t saved_tsp_args[TSP_NUM_ARGS];
-#if TSPD_ROUTE_IRQ_TO_EL3
-	sp_ctx_regs_t sp_ctx;
+	uint64_t saved_tsp_args[TSPD_NUM_STD_CTX][TSP_NUM_ARGS];
+	uint32_t std_ctx_idx;
+	uint32_t std_ctx_active;
+#if TSPD_NUM_STD_CTX > 1
+	cpu_context_t std_ctx[TSPD_NUM_STD_CTX - 1];
 #endif
+	cpu_context_t fiq_ctx;
 } tsp_context_t;
 
 /* Helper macros to store and retrieve tsp args from tsp_context */
 #define store_tsp_args(tsp_ctx, x1, x2)		do {\
-				tsp_ctx->saved_tsp_args[0] = x1;\
-				tsp_ctx->saved_tsp_args[1] = x2;\
+		tsp_ctx->saved_tsp_args[tsp_ctx->std_ctx_idx][0] = x1;\
+		tsp_ctx->saved_tsp_args[tsp_ctx->std_ctx_idx][1] = x2;\
 			} while (0)
 
 #define get_tsp_args(tsp_ctx, x1, x2)	do {\
-				x1 = tsp_ctx->saved_tsp_args[0];\
-				x2 = tsp_ctx->saved_tsp_args[1];\
+		x1 = tsp_ctx->saved_tsp_args[tsp_ctx->std_ctx_idx][0];\
+		x2 = tsp_ctx->saved_tsp_args[tsp_ctx->std_ctx_idx][1];\
 			} while (0)
 
 /* TSPD power management handlers */
 extern const spd_pm_ops_t tspd_pm;
 
+#if TSPD_STD_SMC_WORKER
+/*
+ * Index of the standard SMC context reported to the normal world for a request
+ * handed over to the worker cpu, and number of results of such a request.
+ */
+#define TSPD_WORKER_CTX		TSPD_NUM_STD_CTX
+#define TSPD_WORKER_NUM_RETS	4
+#endif
+
+#if TSPD_STATS
+/* Events counted per cpu by the TSPD, and number of results of a stats query */
+#define TSPD_STATS_STD_SMC	0	/* Fresh standard SMCs */
+#define TSPD_STATS_FAST_SMC	1	/* Fast SMCs */
+#define TSPD_STATS_RESUME	2	/* Resumed standard SMCs */
+#define TSPD_STATS_PREEMPT	3	/* Preemptions by NS interrupts */
+#define TSPD_STATS_EL3_FIQ	4	/* Preemptions by EL3 FIQs */
+#define TSPD_STATS_FIQ		5	/* S-EL1 FIQ round trips */
+#define TSPD_STATS_NUM_EVENTS	6
+#define TSPD_STATS_NUM_RETS	3
+#endif
+
 /*******************************************************************************
  * Forward declarations
  ******************************************************************************/
@@ -238,6 +225,38 @@ uint64_t tspd_enter_sp(uint64_t *c_rt_ctx);
 void __dead2 tspd_exit_sp(uint64_t c_rt_ctx, uint64_t ret);
 uint64_t tspd_synchronous_sp_entry(tsp_context_t *tsp_ctx);
 void __dead2 tspd_synchronous_sp_exit(tsp_context_t *tsp_ctx, uint64_t ret);
+int32_t tspd_get_free_std_ctx(tsp_context_t *tsp_ctx);
+void tspd_select_std_ctx(tsp_context_t *tsp_ctx, uint32_t idx);
+void tspd_set_std_smc_active(tsp_context_t *tsp_ctx);
+void tspd_clr_std_smc_active(tsp_context_t *tsp_ctx);
+void tspd_complete_pm_entry(tsp_context_t *tsp_ctx);
+#if TSPD_STD_SMC_WORKER
+int32_t tspd_worker_queue(uint32_t linear_id,
+			  uint32_t smc_fid,
+			  uint64_t x1,
+			  uint64_t x2);
+int32_t tspd_worker_poll(uint32_t linear_id,
+			 uint64_t rets[TSPD_WORKER_NUM_RETS]);
+int32_t tspd_worker_run(tsp_context_t *tsp_ctx);
+int32_t tspd_worker_owns_ctx(tsp_context_t *tsp_ctx, uint32_t idx);
+int32_t tspd_worker_holds_req(void);
+void tspd_worker_preempted(void);
+void tspd_worker_done(uint64_t x1, uint64_t x2, uint64_t x3, uint64_t x4);
+void tspd_worker_ctx_freed(void);
+void tspd_worker_flush(void);
+#endif
+#if TSPD_STATS
+void tspd_stats_count(uint32_t event);
+void tspd_stats_sp_entry(void);
+void tspd_stats_sp_exit(void);
+int32_t tspd_stats_get(uint64_t mpidr,
+		       uint32_t group,
+		       uint64_t rets[TSPD_STATS_NUM_RETS]);
+#else
+#define tspd_stats_count(event)
+#define tspd_stats_sp_entry()
+#define tspd_stats_sp_exit()
+#endif
 void tspd_init_tsp_ep_state(struct entry_point_info *tsp_ep,
 				uint32_t rw,
 				uint64_t pc,
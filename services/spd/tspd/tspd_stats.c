@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <arch_helpers.h>
+#include <assert.h>
+#include <errno.h>
+#include <platform.h>
+#include <platform_def.h>
+#include <tsp.h>
+#include "tspd_private.h"
+
+/*******************************************************************************
+ * Per-cpu TSPD statistics. 'entry_ts' holds the system counter value when the
+ * TSPD last entered the TSP, or 0 if the cpu is running in the normal world.
+ * 'secure_ticks' and 'max_ticks' are the total and longest time spent in the
+ * secure world between an entry into the TSP and the next return to the normal
+ * world, including the time spent in EL3 meanwhile.
+ ******************************************************************************/
+typedef struct tspd_stats {
+	uint64_t entry_ts;
+	uint64_t secure_ticks;
+	uint64_t max_ticks;
+	uint64_t entry_count;
+	uint64_t count[TSPD_STATS_NUM_EVENTS];
+} __aligned(CACHE_WRITEBACK_GRANULE) tspd_stats_t;
+
+static tspd_stats_t tspd_stats[TSPD_CORE_COUNT];
+
+/*******************************************************************************
+ * This function counts an occurrence of 'event' on the current cpu
+ ******************************************************************************/
+void tspd_stats_count(uint32_t event)
+{
+	assert(event < TSPD_STATS_NUM_EVENTS);
+
+	tspd_stats[platform_get_core_pos(read_mpidr())].count[event]++;
+}
+
+/*******************************************************************************
+ * This function is called just before the TSPD enters the TSP from the normal
+ * world, to record the timestamp of the entry.
+ ******************************************************************************/
+void tspd_stats_sp_entry(void)
+{
+	tspd_stats_t *stats;
+
+	stats = &tspd_stats[platform_get_core_pos(read_mpidr())];
+	stats->entry_ts = read_cntpct_el0();
+	stats->entry_count++;
+}
+
+/*******************************************************************************
+ * This function is called when the TSPD returns from the TSP to the normal
+ * world. It accounts the time since the matching entry, if the TSP was entered
+ * through the TSPD.
+ ******************************************************************************/
+void tspd_stats_sp_exit(void)
+{
+	tspd_stats_t *stats;
+	uint64_t delta;
+
+	stats = &tspd_stats[platform_get_core_pos(read_mpidr())];
+	if (!stats->entry_ts)
+		return;
+
+	delta = read_cntpct_el0() - stats->entry_ts;
+	stats->secure_ticks += delta;
+	if (delta > stats->max_ticks)
+		stats->max_ticks = delta;
+	stats->entry_ts = 0;
+}
+
+/*******************************************************************************
+ * This function returns the statistics in 'group' for the cpu identified by
+ * 'mpidr' in 'rets'. Times are expressed in system counter ticks.
+ ******************************************************************************/
+int32_t tspd_stats_get(uint64_t mpidr,
+		       uint32_t group,
+		       uint64_t rets[TSPD_STATS_NUM_RETS])
+{
+	tspd_stats_t *stats;
+	uint32_t linear_id;
+
+	linear_id = platform_get_core_pos(mpidr);
+	if (linear_id >= TSPD_CORE_COUNT)
+		return -EINVAL;
+
+	stats = &tspd_stats[linear_id];
+
+	switch (group) {
+	case TSP_STATS_SMC:
+		rets[0] = stats->count[TSPD_STATS_STD_SMC];
+		rets[1] = stats->count[TSPD_STATS_FAST_SMC];
+		rets[2] = stats->count[TSPD_STATS_RESUME];
+		break;
+	case TSP_STATS_PREEMPT:
+		rets[0] = stats->count[TSPD_STATS_PREEMPT];
+		rets[1] = stats->count[TSPD_STATS_EL3_FIQ];
+		rets[2] = stats->count[TSPD_STATS_FIQ];
+		break;
+	case TSP_STATS_TIME:
+		rets[0] = stats->entry_count;
+		rets[1] = stats->secure_ticks;
+		rets[2] = stats->max_ticks;
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	return 0;
+}
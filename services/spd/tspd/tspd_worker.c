@@ -0,0 +1,418 @@
+/*
+ * Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <arch_helpers.h>
+#include <assert.h>
+#include <bl_common.h>
+#include <cassert.h>
+#include <context_mgmt.h>
+#include <errno.h>
+#include <platform.h>
+#include <runtime_svc.h>
+#include <spinlock.h>
+#include <tsp.h>
+#include "tspd_private.h"
+
+/*******************************************************************************
+ * States of the standard SMC which a cpu has handed over to the worker cpu
+ ******************************************************************************/
+#define TSPD_WORKER_REQ_IDLE		0
+#define TSPD_WORKER_REQ_QUEUED		1
+#define TSPD_WORKER_REQ_RUNNING		2
+#define TSPD_WORKER_REQ_PREEMPTED	3
+#define TSPD_WORKER_REQ_DONE		4
+
+/*******************************************************************************
+ * Structure which holds the standard SMC handed over to the worker cpu by a
+ * cpu, along with its results once the TSP has completed it.
+ ******************************************************************************/
+typedef struct tspd_worker_req {
+	uint32_t state;
+	uint32_t smc_fid;
+	uint64_t args[TSP_NUM_ARGS];
+	uint64_t rets[TSPD_WORKER_NUM_RETS];
+} tspd_worker_req_t;
+
+CASSERT(TSPD_WORKER_CORE_POS < TSPD_CORE_COUNT, \
+	assert_tspd_worker_core_pos_out_of_range);
+
+/*
+ * The worker cpu runs a request handed over by another cpu in a standard SMC
+ * context of its own. With a single one, its normal world could not issue any
+ * standard SMC while such a request is preempted.
+ */
+CASSERT(TSPD_NUM_STD_CTX > 1, assert_tspd_worker_needs_std_ctx);
+
+/* Request of each cpu. The one of the worker cpu is unused. */
+static tspd_worker_req_t tspd_worker_reqs[TSPD_CORE_COUNT];
+static spinlock_t tspd_worker_lock;
+
+/*
+ * Cpu whose request the worker cpu is running or has been preempted in, or -1,
+ * and the standard SMC context of the worker cpu it uses. Only the worker cpu
+ * updates these outside of tspd_worker_flush().
+ */
+static int32_t tspd_worker_cur = -1;
+static uint32_t tspd_worker_idx;
+
+/*
+ * Set from the time the worker cpu is woken up until it looks for a request to
+ * run, or while the queued requests wait for a free standard SMC context on
+ * it, so that it is not woken up again in the meantime.
+ */
+static int32_t tspd_worker_kicked;
+
+/*******************************************************************************
+ * This function returns 1 if the worker cpu has to be woken up to look for a
+ * request to run and records that it is, or 0 if a wake up is already pending.
+ * It must be called with the worker lock held.
+ ******************************************************************************/
+static int32_t tspd_worker_need_kick(void)
+{
+	if (tspd_worker_kicked)
+		return 0;
+
+	tspd_worker_kicked = 1;
+	return 1;
+}
+
+/*******************************************************************************
+ * This function raises the SGI which wakes up the worker cpu so that it looks
+ * for a request to run.
+ ******************************************************************************/
+static void tspd_worker_kick(void)
+{
+	plat_ic_raise_sgi(TSP_IRQ_WORKER_SGI,
+			  tspd_sp_context[TSPD_WORKER_CORE_POS].mpidr);
+}
+
+/*******************************************************************************
+ * This function returns the cpu with the first queued request or -1 if there
+ * is none. It must be called with the worker lock held.
+ ******************************************************************************/
+static int32_t tspd_worker_find_queued(void)
+{
+	int32_t i;
+
+	for (i = 0; i < TSPD_CORE_COUNT; i++) {
+		if (tspd_worker_reqs[i].state == TSPD_WORKER_REQ_QUEUED)
+			return i;
+	}
+
+	return -1;
+}
+
+/*******************************************************************************
+ * This function returns the index of a free additional standard SMC context of
+ * the worker cpu or -1 if there is none. Requests handed over by other cpus are
+ * never run in 'cpu_ctx', which the power management entries into the TSP
+ * overwrite, so that a preempted one survives the suspension of the worker cpu.
+ ******************************************************************************/
+static int32_t tspd_worker_get_free_ctx(tsp_context_t *tsp_ctx)
+{
+	int32_t idx;
+
+	for (idx = 1; idx < TSPD_NUM_STD_CTX; idx++) {
+		if (!(tsp_ctx->std_ctx_active & (1 << idx)))
+			return idx;
+	}
+
+	return -1;
+}
+
+/*******************************************************************************
+ * This function hands the standard SMC 'smc_fid' issued by the normal world of
+ * the calling cpu over to the worker cpu and wakes it up. It returns 0 upon
+ * success, -EBUSY if the calling cpu has an earlier request which has not been
+ * collected yet and -EAGAIN if the request has to be run on the calling cpu
+ * i.e. it is the worker cpu, it has a standard SMC of its own in progress or
+ * the TSP is off on the worker cpu.
+ ******************************************************************************/
+int32_t tspd_worker_queue(uint32_t linear_id,
+			  uint32_t smc_fid,
+			  uint64_t x1,
+			  uint64_t x2)
+{
+	tspd_worker_req_t *req = &tspd_worker_reqs[linear_id];
+	tsp_context_t *worker_ctx = &tspd_sp_context[TSPD_WORKER_CORE_POS];
+	int32_t rc = 0, kick = 0;
+
+	spin_lock(&tspd_worker_lock);
+
+	if (req->state != TSPD_WORKER_REQ_IDLE) {
+		rc = -EBUSY;
+	} else if (linear_id == TSPD_WORKER_CORE_POS ||
+		   get_std_smc_active_flag(tspd_sp_context[linear_id].state) ||
+		   get_tsp_pstate(worker_ctx->state) == TSP_PSTATE_OFF) {
+		rc = -EAGAIN;
+	} else {
+		req->smc_fid = smc_fid;
+		req->args[0] = x1;
+		req->args[1] = x2;
+		req->state = TSPD_WORKER_REQ_QUEUED;
+		kick = tspd_worker_need_kick();
+	}
+
+	spin_unlock(&tspd_worker_lock);
+
+	if (kick)
+		tspd_worker_kick();
+
+	return rc;
+}
+
+/*******************************************************************************
+ * This function is called when the normal world of the calling cpu resumes a
+ * standard SMC. It returns -ENOENT if the cpu has not handed a request over to
+ * the worker cpu, -EINPROGRESS if the request has not completed yet and 0 once
+ * it has, with its results in 'rets'. The worker cpu is woken up for a request
+ * which it has not started or has been preempted in, unless a wake up is
+ * already pending, so that a caller polling in a loop does not flood it with
+ * SGIs.
+ ******************************************************************************/
+int32_t tspd_worker_poll(uint32_t linear_id,
+			 uint64_t rets[TSPD_WORKER_NUM_RETS])
+{
+	tspd_worker_req_t *req = &tspd_worker_reqs[linear_id];
+	int32_t rc = -EINPROGRESS, kick = 0, i;
+
+	spin_lock(&tspd_worker_lock);
+
+	switch (req->state) {
+	case TSPD_WORKER_REQ_IDLE:
+		rc = -ENOENT;
+		break;
+	case TSPD_WORKER_REQ_DONE:
+		for (i = 0; i < TSPD_WORKER_NUM_RETS; i++)
+			rets[i] = req->rets[i];
+		req->state = TSPD_WORKER_REQ_IDLE;
+		rc = 0;
+		break;
+	case TSPD_WORKER_REQ_QUEUED:
+	case TSPD_WORKER_REQ_PREEMPTED:
+		kick = tspd_worker_need_kick();
+		break;
+	default:
+		break;
+	}
+
+	spin_unlock(&tspd_worker_lock);
+
+	if (kick)
+		tspd_worker_kick();
+
+	return rc;
+}
+
+/*******************************************************************************
+ * This function is called on the worker cpu after the TSP has handled an S-EL1
+ * interrupt taken from the normal world, with the non-secure context saved and
+ * 'cpu_ctx' selected. It resumes the request the TSP was preempted in, or else
+ * starts the first queued request in a free standard SMC context, as if it had
+ * been issued on this cpu. It returns 1 if the TSP is to be entered through the
+ * current secure context and 0 if there is nothing to run.
+ ******************************************************************************/
+int32_t tspd_worker_run(tsp_context_t *tsp_ctx)
+{
+	tspd_worker_req_t *req;
+	cpu_context_t *ctx;
+	int32_t idx, start = 0;
+
+	assert(tsp_ctx == &tspd_sp_context[TSPD_WORKER_CORE_POS]);
+
+	spin_lock(&tspd_worker_lock);
+
+	if (tspd_worker_cur < 0) {
+		idx = tspd_worker_get_free_ctx(tsp_ctx);
+		if (idx >= 0)
+			tspd_worker_cur = tspd_worker_find_queued();
+
+		/*
+		 * Queued requests which wait for a free context are run once
+		 * tspd_worker_ctx_freed() wakes this cpu up again.
+		 */
+		tspd_worker_kicked = idx < 0 && tspd_worker_find_queued() >= 0;
+
+		if (tspd_worker_cur < 0) {
+			spin_unlock(&tspd_worker_lock);
+			return 0;
+		}
+
+		tspd_worker_idx = idx;
+		start = 1;
+	} else {
+		tspd_worker_kicked = 0;
+	}
+
+	req = &tspd_worker_reqs[tspd_worker_cur];
+	assert(start || req->state == TSPD_WORKER_REQ_PREEMPTED);
+	req->state = TSPD_WORKER_REQ_RUNNING;
+
+	spin_unlock(&tspd_worker_lock);
+
+	tspd_select_std_ctx(tsp_ctx, tspd_worker_idx);
+
+	if (start) {
+		/* Enter the TSP as for a standard SMC issued on this cpu */
+		store_tsp_args(tsp_ctx, req->args[0], req->args[1]);
+		tspd_set_std_smc_active(tsp_ctx);
+		cm_set_elr_el3(SECURE, (uint64_t) &tsp_vectors->std_smc_entry);
+
+		ctx = cm_get_context(SECURE);
+		write_ctx_reg(get_gpregs_ctx(ctx), CTX_GPREG_X0, req->smc_fid);
+		write_ctx_reg(get_gpregs_ctx(ctx), CTX_GPREG_X1, req->args[0]);
+		write_ctx_reg(get_gpregs_ctx(ctx), CTX_GPREG_X2, req->args[1]);
+		write_ctx_reg(get_gpregs_ctx(ctx), CTX_GPREG_X3,
+			      tspd_worker_idx);
+	}
+
+	tspd_stats_count(start ? TSPD_STATS_STD_SMC : TSPD_STATS_RESUME);
+
+#if TSPD_ROUTE_IRQ_TO_EL3
+	enable_intr_rm_local(INTR_TYPE_NS, SECURE);
+#endif
+
+	cm_el1_sysregs_context_restore(SECURE);
+	cm_set_next_eret_context(SECURE);
+
+	return 1;
+}
+
+/*******************************************************************************
+ * This function returns 1 if the standard SMC context 'idx' of the calling cpu
+ * holds the request handed over to the worker cpu. The normal world of the
+ * worker cpu did not issue this request, so it must neither be told about nor
+ * be allowed to resume it.
+ ******************************************************************************/
+int32_t tspd_worker_owns_ctx(tsp_context_t *tsp_ctx, uint32_t idx)
+{
+	return tsp_ctx == &tspd_sp_context[TSPD_WORKER_CORE_POS] &&
+		tspd_worker_cur >= 0 && tspd_worker_idx == idx;
+}
+
+/*******************************************************************************
+ * This function returns 1 if the worker cpu holds a request handed over by
+ * another cpu which it has started and not completed yet.
+ ******************************************************************************/
+int32_t tspd_worker_holds_req(void)
+{
+	return tspd_worker_cur >= 0;
+}
+
+/*******************************************************************************
+ * This function records that the TSP has been preempted in the request handed
+ * over to the worker cpu. It is resumed when the worker cpu is woken up next.
+ ******************************************************************************/
+void tspd_worker_preempted(void)
+{
+	assert(tspd_worker_cur >= 0);
+
+	spin_lock(&tspd_worker_lock);
+	tspd_worker_reqs[tspd_worker_cur].state = TSPD_WORKER_REQ_PREEMPTED;
+	spin_unlock(&tspd_worker_lock);
+}
+
+/*******************************************************************************
+ * This function records the results of the request handed over to the worker
+ * cpu for the issuing cpu to collect. The worker cpu wakes itself up again if
+ * more requests are queued.
+ ******************************************************************************/
+void tspd_worker_done(uint64_t x1, uint64_t x2, uint64_t x3, uint64_t x4)
+{
+	tspd_worker_req_t *req;
+	int32_t more;
+
+	assert(tspd_worker_cur >= 0);
+
+	spin_lock(&tspd_worker_lock);
+
+	req = &tspd_worker_reqs[tspd_worker_cur];
+	req->rets[0] = x1;
+	req->rets[1] = x2;
+	req->rets[2] = x3;
+	req->rets[3] = x4;
+	req->state = TSPD_WORKER_REQ_DONE;
+	tspd_worker_cur = -1;
+
+	more = tspd_worker_find_queued() >= 0 && tspd_worker_need_kick();
+
+	spin_unlock(&tspd_worker_lock);
+
+	if (more)
+		tspd_worker_kick();
+}
+
+/*******************************************************************************
+ * This function is called on the worker cpu when a standard SMC issued by its
+ * own normal world has completed and freed a standard SMC context. It wakes the
+ * worker cpu up again if queued requests have been waiting for one.
+ ******************************************************************************/
+void tspd_worker_ctx_freed(void)
+{
+	int32_t kick;
+
+	spin_lock(&tspd_worker_lock);
+	kick = tspd_worker_kicked && tspd_worker_cur < 0 &&
+		tspd_worker_find_queued() >= 0;
+	spin_unlock(&tspd_worker_lock);
+
+	if (kick)
+		tspd_worker_kick();
+}
+
+/*******************************************************************************
+ * This function is called on the worker cpu once the TSP has been turned off
+ * on it. The cpu cannot be turned off while it holds a started request (see
+ * tspd_cpu_off_handler()), so the queued requests complete with SMC_UNK.
+ ******************************************************************************/
+void tspd_worker_flush(void)
+{
+	tspd_worker_req_t *req;
+	int32_t i, j;
+
+	spin_lock(&tspd_worker_lock);
+
+	for (i = 0; i < TSPD_CORE_COUNT; i++) {
+		req = &tspd_worker_reqs[i];
+		if (req->state == TSPD_WORKER_REQ_IDLE ||
+		    req->state == TSPD_WORKER_REQ_DONE)
+			continue;
+
+		req->rets[0] = SMC_UNK;
+		for (j = 1; j < TSPD_WORKER_NUM_RETS; j++)
+			req->rets[j] = 0;
+		req->state = TSPD_WORKER_REQ_DONE;
+	}
+
+	tspd_worker_cur = -1;
+	tspd_worker_kicked = 0;
+
+	spin_unlock(&tspd_worker_lock);
+}
@@ -188,6 +188,64 @@ static int psci_call_on_handlers(aff_map_node_t *target_cpu_nodes[],
 	return rc;
 }
 
+/*******************************************************************************
+ * This function powers on the cpu 'target_cpu' whose affinity instance nodes
+ * are passed in 'target_cpu_nodes'. The caller must have acquired the locks of
+ * these nodes.
+ ******************************************************************************/
+static int psci_afflvl_on_locked(unsigned long target_cpu,
+				 entry_point_info_t *ep,
+				 int start_afflvl,
+				 int end_afflvl,
+				 aff_map_node_t *target_cpu_nodes[])
+{
+	int rc;
+
+	/*
+	 * Generic management: Ensure that the cpu is off to be
+	 * turned on.
+	 */
+	rc = cpu_on_validate_state(psci_get_state(
+				    target_cpu_nodes[MPIDR_AFFLVL0]));
+	if (rc != PSCI_E_SUCCESS)
+		return rc;
+
+	/*
+	 * Call the cpu on handler registered by the Secure Payload Dispatcher
+	 * to let it do any bookeeping. If the handler encounters an error, it's
+	 * expected to assert within
+	 */
+	if (psci_spd_pm && psci_spd_pm->svc_on)
+		psci_spd_pm->svc_on(target_cpu);
+
+	/* Perform generic, architecture and platform specific handling. */
+	rc = psci_call_on_handlers(target_cpu_nodes,
+				   start_afflvl,
+				   end_afflvl,
+				   target_cpu);
+
+	assert(rc == PSCI_E_SUCCESS || rc == PSCI_E_INTERN_FAIL);
+
+	/*
+	 * This function updates the state of each affinity instance
+	 * corresponding to the mpidr in the range of affinity levels
+	 * specified.
+	 */
+	if (rc == PSCI_E_SUCCESS) {
+		psci_do_afflvl_state_mgmt(start_afflvl,
+					  end_afflvl,
+					  target_cpu_nodes,
+					  PSCI_STATE_ON_PENDING);
+
+		/*
+		 * Store the re-entry information for the non-secure world.
+		 */
+		cm_init_context(target_cpu, ep);
+	}
+
+	return rc;
+}
+
 /*******************************************************************************
  * Generic handler which is called to physically power on a cpu identified by
  * its mpidr. It traverses through all the affinity levels performing generic,
@@ -240,58 +298,105 @@ int psci_afflvl_on(unsigned long target_cpu,
 				  end_afflvl,
 				  target_cpu_nodes);
 
-	/*
-	 * Generic management: Ensure that the cpu is off to be
-	 * turned on.
-	 */
-	rc = cpu_on_validate_state(psci_get_state(
-				    target_cpu_nodes[MPIDR_AFFLVL0]));
-	if (rc != PSCI_E_SUCCESS)
-		goto exit;
+	rc = psci_afflvl_on_locked(target_cpu,
+				   ep,
+				   start_afflvl,
+				   end_afflvl,
+				   target_cpu_nodes);
 
 	/*
-	 * Call the cpu on handler registered by the Secure Payload Dispatcher
-	 * to let it do any bookeeping. If the handler encounters an error, it's
-	 * expected to assert within
+	 * This loop releases the lock corresponding to each affinity level
+	 * in the reverse order to which they were acquired.
 	 */
-	if (psci_spd_pm && psci_spd_pm->svc_on)
-		psci_spd_pm->svc_on(target_cpu);
+	psci_release_afflvl_locks(start_afflvl,
+				  end_afflvl,
+				  target_cpu_nodes);
 
-	/* Perform generic, architecture and platform specific handling. */
-	rc = psci_call_on_handlers(target_cpu_nodes,
-				   start_afflvl,
-				   end_afflvl,
-				   target_cpu);
+	return rc;
+}
 
-	assert(rc == PSCI_E_SUCCESS || rc == PSCI_E_INTERN_FAIL);
+/*******************************************************************************
+ * Generic handler which is called to physically power on a set of cpus in the
+ * same cluster. 'cluster_mpidr' is the mpidr of the cluster with an affinity
+ * level 0 field of 0 and bit 'n' of 'cpu_mask' selects the cpu whose affinity
+ * level 0 field is 'n'. Each cpu is turned on as if psci_afflvl_on() had been
+ * called for it, but the locks of the affinity levels above the cpus are only
+ * acquired once for the whole set. The mask of the cpus which have been turned
+ * on is returned in 'on_mask'. The return value is the error of the first cpu
+ * which could not be turned on, if any.
+ ******************************************************************************/
+int psci_afflvl_on_batch(unsigned long cluster_mpidr,
+			 unsigned long cpu_mask,
+			 entry_point_info_t *ep,
+			 int start_afflvl,
+			 int end_afflvl,
+			 unsigned long *on_mask)
+{
+	int rc, ret = PSCI_E_SUCCESS;
+	unsigned int aff0;
+	unsigned long mask, target_cpu;
+	mpidr_aff_map_nodes_t target_cpu_nodes;
+
+	assert(psci_plat_pm_ops->affinst_on &&
+			psci_plat_pm_ops->affinst_on_finish);
+	assert(start_afflvl == MPIDR_AFFLVL0 && cpu_mask);
 
 	/*
-	 * This function updates the state of each affinity instance
-	 * corresponding to the mpidr in the range of affinity levels
-	 * specified.
+	 * The nodes above affinity level 0 are shared by all the cpus in the
+	 * set, so collect them once using the first cpu.
 	 */
-	if (rc == PSCI_E_SUCCESS) {
-		psci_do_afflvl_state_mgmt(start_afflvl,
-					  end_afflvl,
-					  target_cpu_nodes,
-					  PSCI_STATE_ON_PENDING);
-
-		/*
-		 * Store the re-entry information for the non-secure world.
-		 */
-		cm_init_context(target_cpu, ep);
-	}
+	target_cpu = cluster_mpidr | __builtin_ctzl(cpu_mask);
+	rc = psci_get_aff_map_nodes(target_cpu,
+				    start_afflvl,
+				    end_afflvl,
+				    target_cpu_nodes);
+	assert(rc == PSCI_E_SUCCESS);
 
-exit:
 	/*
-	 * This loop releases the lock corresponding to each affinity level
-	 * in the reverse order to which they were acquired.
+	 * Acquire the locks of the cpus in ascending mpidr order, like
+	 * psci_set_suspend_mode() does, and then the locks of the higher
+	 * affinity levels as psci_afflvl_on() would.
 	 */
-	psci_release_afflvl_locks(start_afflvl,
+	for (mask = cpu_mask; mask; mask &= mask - 1) {
+		aff0 = __builtin_ctzl(mask);
+		psci_lock_get(psci_get_aff_map_node(cluster_mpidr | aff0,
+						    MPIDR_AFFLVL0));
+	}
+
+	psci_acquire_afflvl_locks(start_afflvl + 1,
 				  end_afflvl,
 				  target_cpu_nodes);
 
-	return rc;
+	*on_mask = 0;
+	for (mask = cpu_mask; mask; mask &= mask - 1) {
+		aff0 = __builtin_ctzl(mask);
+		target_cpu = cluster_mpidr | aff0;
+		target_cpu_nodes[MPIDR_AFFLVL0] =
+			psci_get_aff_map_node(target_cpu, MPIDR_AFFLVL0);
+
+		rc = psci_afflvl_on_locked(target_cpu,
+					   ep,
+					   start_afflvl,
+					   end_afflvl,
+					   target_cpu_nodes);
+		if (rc == PSCI_E_SUCCESS)
+			*on_mask |= 1UL << aff0;
+		else if (ret == PSCI_E_SUCCESS)
+			ret = rc;
+	}
+
+	/* Release the locks in the reverse order to which they were acquired */
+	psci_release_afflvl_locks(start_afflvl + 1,
+				  end_afflvl,
+				  target_cpu_nodes);
+
+	for (mask = cpu_mask; mask; mask &= ~(1UL << aff0)) {
+		aff0 = 63 - __builtin_clzl(mask);
+		psci_lock_release(psci_get_aff_map_node(cluster_mpidr | aff0,
+							MPIDR_AFFLVL0));
+	}
+
+	return ret;
 }
 
 /*******************************************************************************
@@ -225,6 +225,54 @@ static void psci_call_suspend_handlers(aff_map_node_t *mpidr_nodes[],
 	}
 }
 
+/*******************************************************************************
+ * In OS initiated mode, a cpu may only request an affinity level above a cpu
+ * to be powered down if it is the last cpu running in each affinity instance
+ * up to that level. As every running cpu holds a reference on all the affinity
+ * instances containing it in this mode, the calling cpu must be the only one
+ * holding a reference on each of them.
+ ******************************************************************************/
+static int psci_validate_os_init_afflvl(aff_map_node_t *mpidr_nodes[],
+					int afflvl)
+{
+	int level;
+	aff_map_node_t *node;
+
+	for (level = MPIDR_AFFLVL1; level <= afflvl; level++) {
+		node = mpidr_nodes[level];
+		if (node == NULL)
+			continue;
+
+		if (node->ref_count != 1)
+			return PSCI_E_DENIED;
+	}
+
+	return PSCI_E_SUCCESS;
+}
+
+/*******************************************************************************
+ * In OS initiated mode, this function marks the affinity instances above the
+ * target affinity level 'afflvl' which no longer have a running cpu as left
+ * powered on. The affinity level specific handlers are not called for them so
+ * they remain physically on until the next cpu in them powers up.
+ ******************************************************************************/
+static void psci_hold_on_afflvls(aff_map_node_t *mpidr_nodes[],
+				 int afflvl,
+				 int end_afflvl)
+{
+	int level;
+	aff_map_node_t *node;
+
+	for (level = afflvl + 1; level <= end_afflvl; level++) {
+		node = mpidr_nodes[level];
+		if (node == NULL || psci_get_state(node) != PSCI_STATE_OFF)
+			continue;
+
+		node->held_on = 1;
+		psci_flush_aff_node(node);
+	}
+}
+
 /*******************************************************************************
  * Top level handler which is called when a cpu wants to suspend its execution.
  * It is assumed that along with turning the cpu off, higher affinity levels
@@ -244,15 +292,21 @@ static void psci_call_suspend_handlers(aff_map_node_t *mpidr_nodes[],
  * to turn off affinity level X it is neccesary to turn off affinity level X - 1
  * first.
  *
+ * In OS initiated mode, the state of all the affinity levels is changed
+ * irrespective of the target affinity level and PSCI_E_DENIED is returned if
+ * the target affinity level cannot be powered down because another cpu is
+ * still running in it.
+ *
  * All the required parameter checks are performed at the beginning and after
  * the state transition has been done, no further error is expected and it
  * is not possible to undo any of the actions taken beyond that point.
  ******************************************************************************/
-void psci_afflvl_suspend(entry_point_info_t *ep,
+int psci_afflvl_suspend(entry_point_info_t *ep,
 			int start_afflvl,
 			int end_afflvl)
 {
-	int skip_wfi = 0;
+	int skip_wfi = 0, rc = PSCI_E_SUCCESS;
+	int mgmt_afflvl = end_afflvl, max_afflvl = get_max_afflvl();
 	mpidr_aff_map_nodes_t mpidr_nodes;
 	unsigned int max_phys_off_afflvl;
 
@@ -271,18 +325,36 @@ void psci_afflvl_suspend(entry_point_info_t *ep,
 	 * therefore assert.
 	 */
 	if (psci_get_aff_map_nodes(read_mpidr_el1() & MPIDR_AFFINITY_MASK,
-		   start_afflvl, end_afflvl, mpidr_nodes) != PSCI_E_SUCCESS)
+		   start_afflvl, max_afflvl, mpidr_nodes) != PSCI_E_SUCCESS)
 		assert(0);
 
+	/*
+	 * The suspend mode cannot change while this cpu holds its own lock.
+	 * In OS initiated mode the state of all affinity levels is managed.
+	 */
+	psci_acquire_afflvl_locks(start_afflvl,
+				  start_afflvl,
+				  mpidr_nodes);
+	if (psci_suspend_mode == PSCI_MODE_OS_INIT)
+		mgmt_afflvl = max_afflvl;
+
 	/*
 	 * This function acquires the lock corresponding to each affinity
 	 * level so that by the time all locks are taken, the system topology
 	 * is snapshot and state management can be done safely.
 	 */
-	psci_acquire_afflvl_locks(start_afflvl,
-				  end_afflvl,
+	psci_acquire_afflvl_locks(start_afflvl + 1,
+				  mgmt_afflvl,
 				  mpidr_nodes);
 
+	if (psci_suspend_mode == PSCI_MODE_OS_INIT) {
+		rc = psci_validate_os_init_afflvl(mpidr_nodes, end_afflvl);
+		if (rc != PSCI_E_SUCCESS) {
+			skip_wfi = 1;
+			goto exit;
+		}
+	}
+
 	/*
 	 * We check if there are any pending interrupts after the delay
 	 * introduced by lock contention to increase the chances of early
@@ -307,10 +379,13 @@ void psci_afflvl_suspend(entry_point_info_t *ep,
 	 * specified.
 	 */
 	psci_do_afflvl_state_mgmt(start_afflvl,
-				  end_afflvl,
+				  mgmt_afflvl,
 				  mpidr_nodes,
 				  PSCI_STATE_SUSPEND);
 
+	if (mgmt_afflvl > end_afflvl)
+		psci_hold_on_afflvls(mpidr_nodes, end_afflvl, mgmt_afflvl);
+
 	max_phys_off_afflvl = psci_find_max_phys_off_afflvl(start_afflvl,
 							    end_afflvl,
 							    mpidr_nodes);
@@ -319,6 +394,11 @@ void psci_afflvl_suspend(entry_point_info_t *ep,
 	/* Stash the highest affinity level that will be turned off */
 	psci_set_max_phys_off_afflvl(max_phys_off_afflvl);
 
+#if ENABLE_PSCI_STAT
+	/* Record when each affinity level is about to be powered down */
+	psci_stats_update_pwr_down(mpidr_nodes, max_phys_off_afflvl);
+#endif
+
 	/*
 	 * Store the re-entry information for the non-secure world.
 	 */
@@ -342,10 +422,12 @@ exit:
 	 * reverse order to which they were acquired.
 	 */
 	psci_release_afflvl_locks(start_afflvl,
-				  end_afflvl,
+				  mgmt_afflvl,
 				  mpidr_nodes);
 	if (!skip_wfi)
 		psci_power_down_wfi();
+
+	return rc;
 }
 
 /*******************************************************************************
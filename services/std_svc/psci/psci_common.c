@@ -56,6 +56,19 @@ __attribute__ ((section("tzfw_coherent_mem")))
 #endif
 ;
 
+/*******************************************************************************
+ * The mode in which cpu_suspend requests are coordinated. In platform
+ * coordinated mode, a cpu only holds a reference on the affinity instances up
+ * to the affinity level it requests to suspend to, and an affinity instance
+ * is powered down when no cpu holds a reference on it. In OS initiated mode, a
+ * cpu releases its reference on all affinity instances when it suspends and
+ * the last cpu running in an affinity instance decides whether it is powered
+ * down. It can only be changed through PSCI_SET_SUSPEND_MODE when no cpu is
+ * suspended. It is flushed when written as it is read with the data cache
+ * disabled on the warm boot path.
+ ******************************************************************************/
+unsigned int psci_suspend_mode = PSCI_MODE_PLAT_COORD;
+
 /*******************************************************************************
  * Pointer to functions exported by the platform to complete power mgmt. ops
  ******************************************************************************/
@@ -153,6 +166,54 @@ uint32_t psci_get_max_phys_off_afflvl(void)
 	return get_cpu_data(psci_svc_cpu_data.max_phys_off_afflvl);
 }
 
+/*******************************************************************************
+ * This function returns whether the per-cpu initialisation steps in 'steps'
+ * have been done for this cpu since it was first powered on. It is meant to be
+ * called by the platform power on finishers to skip the initialisation which
+ * is retained across the power down of the cpu.
+ ******************************************************************************/
+int psci_get_pcpu_init_done(uint32_t steps)
+{
+	/*
+	 * The finishers run with the data cache disabled, so ensure that the
+	 * value is read from main memory.
+	 */
+	flush_cpu_data(psci_svc_cpu_data.pcpu_init_done);
+	return (get_cpu_data(psci_svc_cpu_data.pcpu_init_done) & steps) ==
+		steps;
+}
+
+/*******************************************************************************
+ * This function records that the per-cpu initialisation steps in 'steps' have
+ * been done for this cpu.
+ ******************************************************************************/
+void psci_set_pcpu_init_done(uint32_t steps)
+{
+	flush_cpu_data(psci_svc_cpu_data.pcpu_init_done);
+	set_cpu_data(psci_svc_cpu_data.pcpu_init_done,
+		     get_cpu_data(psci_svc_cpu_data.pcpu_init_done) | steps);
+	flush_cpu_data(psci_svc_cpu_data.pcpu_init_done);
+}
+
+/*******************************************************************************
+ * This function records that the per-cpu initialisation steps in 'steps' need
+ * to be done again by all the cpus e.g. because the component holding their
+ * state has been powered down. It must only be called while the other cpus
+ * are powered down.
+ ******************************************************************************/
+void psci_clear_pcpu_init_done(uint32_t steps)
+{
+	uint32_t i;
+
+	for (i = 0; i < PLATFORM_CORE_COUNT; i++) {
+		flush_cpu_data_by_index(i, psci_svc_cpu_data.pcpu_init_done);
+		set_cpu_data_by_index(i, psci_svc_cpu_data.pcpu_init_done,
+			get_cpu_data_by_index(i,
+				psci_svc_cpu_data.pcpu_init_done) & ~steps);
+		flush_cpu_data_by_index(i, psci_svc_cpu_data.pcpu_init_done);
+	}
+}
+
 /*******************************************************************************
  * Routine to return the maximum affinity level to traverse to after a cpu has
  * been physically powered up. It is expected to be called immediately after
@@ -188,6 +249,15 @@ int get_power_on_target_afflvl()
 	afflvl = psci_get_suspend_afflvl();
 	if (afflvl == PSCI_INVALID_DATA)
 		afflvl = get_max_afflvl();
+
+	/*
+	 * In OS initiated mode, a suspended cpu released its reference on all
+	 * the affinity instances containing it so it must take it back on all
+	 * of them.
+	 */
+	if (psci_suspend_mode == PSCI_MODE_OS_INIT)
+		afflvl = get_max_afflvl();
+
 	return afflvl;
 }
 
@@ -320,6 +390,67 @@ int psci_validate_mpidr(unsigned long mpidr, int level)
 		return PSCI_E_INVALID_PARAMS;
 }
 
+/*******************************************************************************
+ * This function returns the number of system counter ticks until the EL1 timer
+ * described by 'ctl' and 'cval' fires, given the current count 'now'. A timer
+ * which is disabled or masked never fires.
+ ******************************************************************************/
+static uint64_t psci_timer_ticks_left(uint64_t ctl, uint64_t cval, uint64_t now)
+{
+	if (!get_cntp_ctl_enable(ctl) || get_cntp_ctl_imask(ctl))
+		return UINT64_MAX;
+
+	return cval > now ? cval - now : 0;
+}
+
+/*******************************************************************************
+ * This function demotes the power state requested through CPU_SUSPEND if the
+ * next deadline of the EL1 physical and virtual timers of the caller is
+ * shorter than the minimum residency of that state. The deepest state in the
+ * platform idle state table which is shallower than the requested one and whose
+ * minimum residency fits is chosen, or the shallowest state if none fits. The
+ * power state is returned unchanged if the platform has not provided a table,
+ * if the state is not in it or in OS initiated mode where the OS chooses.
+ ******************************************************************************/
+unsigned int psci_demote_power_state(unsigned int power_state)
+{
+	const plat_idle_state_t *states = psci_plat_pm_ops->idle_states;
+	uint64_t ticks, vticks, freq;
+	int idx;
+
+	if (!states || psci_suspend_mode == PSCI_MODE_OS_INIT)
+		return power_state;
+
+	for (idx = psci_plat_pm_ops->num_idle_states - 1; idx >= 0; idx--) {
+		if (states[idx].power_state == power_state)
+			break;
+	}
+
+	if (idx <= 0)
+		return power_state;
+
+	ticks = psci_timer_ticks_left(read_cntp_ctl_el0(),
+				      read_cntp_cval_el0(),
+				      read_cntpct_el0());
+	vticks = psci_timer_ticks_left(read_cntv_ctl_el0(),
+				       read_cntv_cval_el0(),
+				       read_cntvct_el0());
+	if (vticks < ticks)
+		ticks = vticks;
+
+	if (ticks == UINT64_MAX)
+		return power_state;
+
+	freq = read_cntfrq_el0();
+	for (; idx > 0; idx--) {
+		if ((uint64_t) states[idx].min_residency * freq / 1000000 <=
+		    ticks)
+			break;
+	}
+
+	return states[idx].power_state;
+}
+
 /*******************************************************************************
  * This function determines the full entrypoint information for the requested
  * PSCI entrypoint on power on/resume and returns it.
@@ -379,19 +510,18 @@ int psci_get_ns_ep_info(entry_point_info_t *ep,
 
 /*******************************************************************************
  * This function takes a pointer to an affinity node in the topology tree and
- * returns its state. State of a non-leaf node needs to be calculated.
+ * returns its state. State of a non-leaf node needs to be calculated. The
+ * state is flushed to main memory when it is updated, so it can be read
+ * without any cache maintenance.
  ******************************************************************************/
 unsigned short psci_get_state(aff_map_node_t *node)
 {
-#if !USE_COHERENT_MEM
-	flush_dcache_range((uint64_t) node, sizeof(*node));
-#endif
-
 	assert(node->level >= MPIDR_AFFLVL0 && node->level <= MPIDR_MAX_AFFLVL);
 
-	/* A cpu node just contains the state which can be directly returned */
+	/* The state of a cpu is kept in its per-cpu data */
 	if (node->level == MPIDR_AFFLVL0)
-		return (node->state >> PSCI_STATE_SHIFT) & PSCI_STATE_MASK;
+		return get_cpu_data_by_index(platform_get_core_pos(node->mpidr),
+					     psci_svc_cpu_data.state);
 
 	/*
 	 * For an affinity level higher than a cpu, the state has to be
@@ -410,44 +540,49 @@ unsigned short psci_get_state(aff_map_node_t *node)
 /*******************************************************************************
  * This function takes a pointer to an affinity node in the topology tree and
  * a target state. State of a non-leaf node needs to be converted to a reference
- * count. State of a leaf node can be set directly.
+ * count. State of a leaf node can be set directly in the per-cpu data of the
+ * cpu, so that only the transitions of the higher affinity levels write to
+ * memory shared between cpus.
  ******************************************************************************/
 void psci_set_state(aff_map_node_t *node, unsigned short state)
 {
+	unsigned int idx;
+
 	assert(node->level >= MPIDR_AFFLVL0 && node->level <= MPIDR_MAX_AFFLVL);
 
+	if (node->level == MPIDR_AFFLVL0) {
+		idx = platform_get_core_pos(node->mpidr);
+		set_cpu_data_by_index(idx, psci_svc_cpu_data.state, state);
+		psci_flush_cpu_state(idx);
+		return;
+	}
+
 	/*
 	 * For an affinity level higher than a cpu, the state is used
 	 * to decide whether the reference count is incremented or
 	 * decremented. Entry into the ON_PENDING state does not have
 	 * effect.
 	 */
-	if (node->level > MPIDR_AFFLVL0) {
-		switch (state) {
-		case PSCI_STATE_ON:
-			node->ref_count++;
-			break;
-		case PSCI_STATE_OFF:
-		case PSCI_STATE_SUSPEND:
-			node->ref_count--;
-			break;
-		case PSCI_STATE_ON_PENDING:
-			/*
-			 * An affinity level higher than a cpu will not undergo
-			 * a state change when it is about to be turned on
-			 */
-			return;
-		default:
-			assert(0);
-		}
-	} else {
-		node->state &= ~(PSCI_STATE_MASK << PSCI_STATE_SHIFT);
-		node->state |= (state & PSCI_STATE_MASK) << PSCI_STATE_SHIFT;
+	switch (state) {
+	case PSCI_STATE_ON:
+		node->ref_count++;
+		node->held_on = 0;
+		break;
+	case PSCI_STATE_OFF:
+	case PSCI_STATE_SUSPEND:
+		node->ref_count--;
+		break;
+	case PSCI_STATE_ON_PENDING:
+		/*
+		 * An affinity level higher than a cpu will not undergo
+		 * a state change when it is about to be turned on
+		 */
+		return;
+	default:
+		assert(0);
 	}
 
-#if !USE_COHERENT_MEM
-	flush_dcache_range((uint64_t) node, sizeof(*node));
-#endif
+	psci_flush_aff_node(node);
 }
 
 /*******************************************************************************
@@ -462,6 +597,11 @@ unsigned short psci_get_phys_state(aff_map_node_t *node)
 	unsigned int state;
 
 	state = psci_get_state(node);
+
+	/* An affinity instance left powered on is physically still on */
+	if (node->level > MPIDR_AFFLVL0 && node->held_on)
+		return PSCI_STATE_ON;
+
 	return get_phys_state(state);
 }
 
@@ -557,6 +697,15 @@ void psci_afflvl_power_on_finish(int start_afflvl,
 					 end_afflvl,
 					 pon_handlers);
 
+#if ENABLE_PSCI_STAT
+	/*
+	 * Account the time spent in a suspended state by the affinity levels
+	 * which have been powered up. This is done after the handlers so that
+	 * the data cache is enabled.
+	 */
+	psci_stats_update_pwr_up(mpidr_nodes, max_phys_off_afflvl);
+#endif
+
 	/*
 	 * This function updates the state of each affinity instance
 	 * corresponding to the mpidr in the range of affinity levels
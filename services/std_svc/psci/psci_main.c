@@ -31,6 +31,7 @@
 #include <arch.h>
 #include <arch_helpers.h>
 #include <assert.h>
+#include <cpu_data.h>
 #include <debug.h>
 #include <platform.h>
 #include <runtime_svc.h>
@@ -88,6 +89,58 @@ int psci_cpu_on(unsigned long target_cpu,
 	return rc;
 }
 
+/*******************************************************************************
+ * Turn on the cpus of the cluster 'cluster_mpidr' selected by 'cpu_mask', bit
+ * 'n' of which selects the cpu whose affinity level 0 field is 'n'. All of them
+ * start at 'entrypoint' with 'context_id'. The mask of the cpus which have been
+ * turned on is returned in 'on_mask'. Nothing is done unless all the cpus exist
+ * and the entrypoint is valid.
+ ******************************************************************************/
+int psci_cpu_on_batch(unsigned long cluster_mpidr,
+		      unsigned long cpu_mask,
+		      unsigned long entrypoint,
+		      unsigned long context_id,
+		      unsigned long *on_mask)
+{
+	int rc;
+	unsigned long mask;
+	entry_point_info_t ep;
+
+	*on_mask = 0;
+
+	if (!cpu_mask || (cluster_mpidr & ~MPIDR_AFFINITY_MASK) ||
+	    (cluster_mpidr & (MPIDR_AFFLVL_MASK << MPIDR_AFF0_SHIFT)))
+		return PSCI_E_INVALID_PARAMS;
+
+	/* Determine if all the cpus exist */
+	for (mask = cpu_mask; mask; mask &= mask - 1) {
+		rc = psci_validate_mpidr(cluster_mpidr | __builtin_ctzl(mask),
+					 MPIDR_AFFLVL0);
+		if (rc != PSCI_E_SUCCESS)
+			return PSCI_E_INVALID_PARAMS;
+	}
+
+	/* Validate the entrypoint using platform pm_ops */
+	if (psci_plat_pm_ops->validate_ns_entrypoint) {
+		rc = psci_plat_pm_ops->validate_ns_entrypoint(entrypoint);
+		if (rc != PSCI_E_SUCCESS) {
+			assert(rc == PSCI_E_INVALID_PARAMS);
+			return PSCI_E_INVALID_PARAMS;
+		}
+	}
+
+	rc = psci_get_ns_ep_info(&ep, entrypoint, context_id);
+	if (rc != PSCI_E_SUCCESS)
+		return rc;
+
+	return psci_afflvl_on_batch(cluster_mpidr,
+				    cpu_mask,
+				    &ep,
+				    MPIDR_AFFLVL0,
+				    get_max_afflvl(),
+				    on_mask);
+}
+
 unsigned int psci_version(void)
 {
 	return PSCI_MAJOR_VER | PSCI_MINOR_VER;
@@ -100,6 +153,9 @@ int psci_cpu_suspend(unsigned int power_state,
 	int rc;
 	unsigned int target_afflvl, pstate_type;
 	entry_point_info_t ep;
+#if ENABLE_PSCI_STAT
+	uint64_t entry_ts;
+#endif
 
 	/* Check SBZ bits in power state are zero */
 	if (psci_validate_power_state(power_state))
@@ -128,6 +184,13 @@ int psci_cpu_suspend(unsigned int power_state,
 		}
 	}
 
+	/*
+	 * Enter a shallower state than the requested one if the caller is due
+	 * to be woken up by its timer before the requested state pays off.
+	 */
+	power_state = psci_demote_power_state(power_state);
+	target_afflvl = psci_get_pstate_afflvl(power_state);
+
 	/* Determine the 'state type' in the 'power_state' parameter */
 	pstate_type = psci_get_pstate_type(power_state);
 
@@ -139,7 +202,13 @@ int psci_cpu_suspend(unsigned int power_state,
 		if  (!psci_plat_pm_ops->affinst_standby)
 			return PSCI_E_INVALID_PARAMS;
 
+#if ENABLE_PSCI_STAT
+		entry_ts = read_cntpct_el0();
+		psci_plat_pm_ops->affinst_standby(power_state);
+		psci_stats_update_standby(entry_ts);
+#else
 		psci_plat_pm_ops->affinst_standby(power_state);
+#endif
 		return PSCI_E_SUCCESS;
 	}
 
@@ -159,13 +228,13 @@ int psci_cpu_suspend(unsigned int power_state,
 	 * Do what is needed to enter the power down state. Upon success,
 	 * enter the final wfi which will power down this CPU.
 	 */
-	psci_afflvl_suspend(&ep,
-			    MPIDR_AFFLVL0,
-			    target_afflvl);
+	rc = psci_afflvl_suspend(&ep,
+				 MPIDR_AFFLVL0,
+				 target_afflvl);
 
 	/* Reset PSCI power state parameter for the core. */
 	psci_set_suspend_power_state(PSCI_INVALID_DATA);
-	return PSCI_E_SUCCESS;
+	return rc;
 }
 
 int psci_system_suspend(unsigned long entrypoint,
@@ -215,13 +284,13 @@ int psci_system_suspend(unsigned long entrypoint,
 	 * Do what is needed to enter the power down state. Upon success,
 	 * enter the final wfi which will power down this cpu.
 	 */
-	psci_afflvl_suspend(&ep,
-			    MPIDR_AFFLVL0,
-			    PLATFORM_MAX_AFFLVL);
+	rc = psci_afflvl_suspend(&ep,
+				 MPIDR_AFFLVL0,
+				 PLATFORM_MAX_AFFLVL);
 
 	/* Reset PSCI power state parameter for the core. */
 	psci_set_suspend_power_state(PSCI_INVALID_DATA);
-	return PSCI_E_SUCCESS;
+	return rc;
 }
 
 int psci_cpu_off(void)
@@ -353,16 +422,67 @@ int psci_features(unsigned int psci_fid)
 			psci_fid == PSCI_CPU_SUSPEND_AARCH64) {
 		/*
 		 * The trusted firmware uses the original power state format
-		 * and does not support OS Initiated Mode.
+		 * and supports OS Initiated Mode.
 		 */
 		return (FF_PSTATE_ORIG << FF_PSTATE_SHIFT) |
-			((!FF_SUPPORTS_OS_INIT_MODE) << FF_MODE_SUPPORT_SHIFT);
+			(FF_SUPPORTS_OS_INIT_MODE << FF_MODE_SUPPORT_SHIFT);
 	}
 
 	/* Return 0 for all other fid's */
 	return PSCI_E_SUCCESS;
 }
 
+/*******************************************************************************
+ * PSCI_SET_SUSPEND_MODE: Switch between the platform coordinated and the OS
+ * initiated modes of coordinating cpu_suspend requests. The references held by
+ * a suspended cpu on the affinity instances containing it depend upon the mode
+ * it suspended in, so the mode can only be changed when no other cpu is
+ * suspended. The locks of all the cpus are held while checking this.
+ ******************************************************************************/
+int psci_set_suspend_mode(unsigned int mode)
+{
+	unsigned long mpidr = read_mpidr_el1() & MPIDR_AFFINITY_MASK;
+	int i, rc = PSCI_E_SUCCESS;
+
+	if (mode != PSCI_MODE_PLAT_COORD && mode != PSCI_MODE_OS_INIT)
+		return PSCI_E_INVALID_PARAMS;
+
+	if (mode == psci_suspend_mode)
+		return PSCI_E_SUCCESS;
+
+	for (i = psci_aff_limits[MPIDR_AFFLVL0].min;
+			i <= psci_aff_limits[MPIDR_AFFLVL0].max; i++) {
+		if (psci_aff_map[i].state & PSCI_AFF_PRESENT)
+			psci_lock_get(&psci_aff_map[i]);
+	}
+
+	for (i = psci_aff_limits[MPIDR_AFFLVL0].min;
+			i <= psci_aff_limits[MPIDR_AFFLVL0].max; i++) {
+		if (!(psci_aff_map[i].state & PSCI_AFF_PRESENT) ||
+		    psci_aff_map[i].mpidr == mpidr)
+			continue;
+
+		if (psci_get_state(&psci_aff_map[i]) == PSCI_STATE_SUSPEND) {
+			rc = PSCI_E_DENIED;
+			break;
+		}
+	}
+
+	if (rc == PSCI_E_SUCCESS) {
+		psci_suspend_mode = mode;
+		flush_dcache_range((uint64_t) &psci_suspend_mode,
+				   sizeof(psci_suspend_mode));
+	}
+
+	for (i = psci_aff_limits[MPIDR_AFFLVL0].max;
+			i >= psci_aff_limits[MPIDR_AFFLVL0].min; i--) {
+		if (psci_aff_map[i].state & PSCI_AFF_PRESENT)
+			psci_lock_release(&psci_aff_map[i]);
+	}
+
+	return rc;
+}
+
 /*******************************************************************************
  * PSCI top level handler for servicing SMCs.
  ******************************************************************************/
@@ -428,6 +548,17 @@ uint64_t psci_smc_handler(uint32_t smc_fid,
 		case PSCI_FEATURES:
 			SMC_RET1(handle, psci_features(x1));
 
+		case PSCI_SET_SUSPEND_MODE:
+			SMC_RET1(handle, psci_set_suspend_mode(x1));
+
+#if ENABLE_PSCI_STAT
+		case PSCI_STAT_RESIDENCY_AARCH32:
+			SMC_RET1(handle, psci_stat_residency(x1, x2));
+
+		case PSCI_STAT_COUNT_AARCH32:
+			SMC_RET1(handle, psci_stat_count(x1, x2));
+#endif
+
 		default:
 			break;
 		}
@@ -453,6 +584,14 @@ uint64_t psci_smc_handler(uint32_t smc_fid,
 		case PSCI_SYSTEM_SUSPEND_AARCH64:
 			SMC_RET1(handle, psci_system_suspend(x1, x2));
 
+#if ENABLE_PSCI_STAT
+		case PSCI_STAT_RESIDENCY_AARCH64:
+			SMC_RET1(handle, psci_stat_residency(x1, x2));
+
+		case PSCI_STAT_COUNT_AARCH64:
+			SMC_RET1(handle, psci_stat_count(x1, x2));
+#endif
+
 		default:
 			break;
 		}
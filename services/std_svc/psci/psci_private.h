@@ -35,12 +35,19 @@
 #include <bakery_lock.h>
 #include <bl_common.h>
 #include <psci.h>
+#include <ticket_lock.h>
 
 /*
  * The following helper macros abstract the interface to the Bakery
- * Lock API.
+ * Lock API. Platforms whose cpus are coherent with the MMU and data cache
+ * enabled throughout the power management operations use a ticket lock
+ * built on the exclusive monitors instead.
  */
-#if USE_COHERENT_MEM
+#if HW_ASSISTED_COHERENCY
+#define psci_lock_init(aff_map, idx)	ticket_lock_init(&(aff_map)[(idx)].lock)
+#define psci_lock_get(node)		ticket_lock_get(&((node)->lock))
+#define psci_lock_release(node)		ticket_lock_release(&((node)->lock))
+#elif USE_COHERENT_MEM
 #define psci_lock_init(aff_map, idx)	bakery_lock_init(&(aff_map)[(idx)].lock)
 #define psci_lock_get(node)		bakery_lock_get(&((node)->lock))
 #define psci_lock_release(node)		bakery_lock_release(&((node)->lock))
@@ -52,6 +59,28 @@
 						CPU_DATA_PSCI_LOCK_OFFSET)
 #endif
 
+/*
+ * The PSCI state is read by cpus running with the data cache disabled during
+ * warm boot, so every update of the state in normal memory must be flushed to
+ * main memory. This is not needed when the cpus stay coherent throughout.
+ * The state of the affinity instances above a cpu is kept in the topology tree,
+ * which may be in coherent memory, while the state of a cpu is kept in its
+ * per-cpu data.
+ */
+#if HW_ASSISTED_COHERENCY
+#define psci_flush_cpu_state(idx)
+#define psci_flush_aff_node(node)
+#else
+#define psci_flush_cpu_state(idx)	\
+		flush_cpu_data_by_index(idx, psci_svc_cpu_data.state)
+#if USE_COHERENT_MEM
+#define psci_flush_aff_node(node)
+#else
+#define psci_flush_aff_node(node)	\
+		flush_dcache_range((uint64_t) (node), sizeof(*(node)))
+#endif
+#endif
+
 /*
  * The PSCI capability which are provided by the generic code but does not
  * depend on the platform or spd capabilities.
@@ -70,7 +99,9 @@
 			define_psci_cap(PSCI_AFFINITY_INFO_AARCH64) |	\
 			define_psci_cap(PSCI_MIG_AARCH64) |		\
 			define_psci_cap(PSCI_MIG_INFO_UP_CPU_AARCH64) |	\
-			define_psci_cap(PSCI_SYSTEM_SUSPEND_AARCH64))
+			define_psci_cap(PSCI_SYSTEM_SUSPEND_AARCH64) |	\
+			define_psci_cap(PSCI_STAT_RESIDENCY_AARCH64) |	\
+			define_psci_cap(PSCI_STAT_COUNT_AARCH64))
 
 
 /*******************************************************************************
@@ -82,7 +113,15 @@ typedef struct aff_map_node {
 	unsigned char ref_count;
 	unsigned char state;
 	unsigned char level;
-#if USE_COHERENT_MEM
+	/*
+	 * Set when an affinity instance above a cpu has no cpu running in it
+	 * but has been left powered on, because in OS initiated mode the last
+	 * cpu to suspend requested a shallower affinity level.
+	 */
+	unsigned char held_on;
+#if HW_ASSISTED_COHERENCY
+	ticket_lock_t lock;
+#elif USE_COHERENT_MEM
 	bakery_lock_t lock;
 #else
 	/* For indexing the bakery_info array in per CPU data */
@@ -105,6 +144,7 @@ extern const plat_pm_ops_t *psci_plat_pm_ops;
 extern aff_map_node_t psci_aff_map[PSCI_NUM_AFFS];
 extern aff_limits_node_t psci_aff_limits[MPIDR_MAX_AFFLVL + 1];
 extern uint32_t psci_caps;
+extern unsigned int psci_suspend_mode;
 
 /*******************************************************************************
  * SPD's power management hooks registered with PSCI
@@ -127,6 +167,7 @@ void psci_afflvl_power_on_finish(int,
 				afflvl_power_on_finisher_t *);
 int psci_get_ns_ep_info(entry_point_info_t *ep,
 		       uint64_t entrypoint, uint64_t context_id);
+unsigned int psci_demote_power_state(unsigned int power_state);
 int psci_check_afflvl_range(int start_afflvl, int end_afflvl);
 void psci_do_afflvl_state_mgmt(uint32_t start_afflvl,
 			       uint32_t end_afflvl,
@@ -158,12 +199,18 @@ int psci_afflvl_on(unsigned long target_cpu,
 		   entry_point_info_t *ep,
 		   int start_afflvl,
 		   int end_afflvl);
+int psci_afflvl_on_batch(unsigned long cluster_mpidr,
+			 unsigned long cpu_mask,
+			 entry_point_info_t *ep,
+			 int start_afflvl,
+			 int end_afflvl,
+			 unsigned long *on_mask);
 
 /* Private exported functions from psci_affinity_off.c */
 int psci_afflvl_off(int, int);
 
 /* Private exported functions from psci_affinity_suspend.c */
-void psci_afflvl_suspend(entry_point_info_t *ep,
+int psci_afflvl_suspend(entry_point_info_t *ep,
 			int start_afflvl,
 			int end_afflvl);
 
@@ -178,4 +225,17 @@ void psci_do_pwrup_cache_maintenance(void);
 void __dead2 psci_system_off(void);
 void __dead2 psci_system_reset(void);
 
+#if ENABLE_PSCI_STAT
+/* Private exported functions from psci_stat.c */
+void psci_stats_update_standby(uint64_t entry_ts);
+void psci_stats_update_pwr_down(aff_map_node_t *mpidr_nodes[],
+				uint32_t max_phys_off_afflvl);
+void psci_stats_update_pwr_up(aff_map_node_t *mpidr_nodes[],
+			      uint32_t max_phys_off_afflvl);
+uint64_t psci_stat_residency(unsigned long target_cpu,
+			     unsigned int power_state);
+uint64_t psci_stat_count(unsigned long target_cpu,
+			 unsigned int power_state);
+#endif
+
 #endif /* __PSCI_PRIVATE_H__ */
@@ -57,6 +57,15 @@ static cpu_context_t psci_ns_context[PLATFORM_CORE_COUNT];
  ******************************************************************************/
 aff_limits_node_t psci_aff_limits[MPIDR_MAX_AFFLVL + 1];
 
+/*******************************************************************************
+ * Pointers to the nodes in 'psci_aff_map' of each affinity level in the mpidr
+ * of a cpu, indexed by the linear id of the cpu. It is populated once the
+ * topology tree has been initialized so that the nodes of a cpu can be looked
+ * up on the power management paths without searching 'psci_aff_map'.
+ ******************************************************************************/
+static aff_map_node_t *psci_cpu_aff_map[PLATFORM_CORE_COUNT]
+				       [MPIDR_MAX_AFFLVL + 1];
+
 /******************************************************************************
  * Define the psci capability variable.
  *****************************************************************************/
@@ -103,13 +112,47 @@ static int psci_aff_map_get_idx(unsigned long key,
 		return mid;
 }
 
+/*******************************************************************************
+ * Look up the node at an affinity level in the mpidr of a cpu in the per-cpu
+ * table of nodes. The linear id derived from an invalid mpidr could point to
+ * the entry of another cpu, so the node is only returned if its mpidr matches
+ * the one being looked up. NULL is returned otherwise, including while the
+ * table is not populated yet.
+ ******************************************************************************/
+static aff_map_node_t *psci_get_cpu_aff_map_node(unsigned long mpidr,
+						 int aff_lvl)
+{
+	unsigned int linear_id;
+	aff_map_node_t *node;
+
+	linear_id = platform_get_core_pos(mpidr);
+	if (linear_id >= PLATFORM_CORE_COUNT)
+		return NULL;
+
+	node = psci_cpu_aff_map[linear_id][aff_lvl];
+	if (node && node->mpidr == mpidr_mask_lower_afflvls(mpidr, aff_lvl))
+		return node;
+
+	return NULL;
+}
+
 aff_map_node_t *psci_get_aff_map_node(unsigned long mpidr, int aff_lvl)
 {
+	aff_map_node_t *node;
 	int rc;
 
 	if (aff_lvl > get_max_afflvl())
 		return NULL;
 
+	/*
+	 * Try the per-cpu table first. Fall back to searching the affinity
+	 * map, which is needed for affinity instances at higher levels which
+	 * are identified by an mpidr that does not belong to a cpu.
+	 */
+	node = psci_get_cpu_aff_map_node(mpidr, aff_lvl);
+	if (node)
+		return node;
+
 	/* Right shift the mpidr to the required affinity level */
 	mpidr = mpidr_mask_lower_afflvls(mpidr, aff_lvl);
 
@@ -188,6 +231,7 @@ static void psci_init_aff_map_node(unsigned long mpidr,
 	psci_aff_map[idx].mpidr = mpidr;
 	psci_aff_map[idx].level = level;
 	psci_lock_init(psci_aff_map, idx);
+	lock_stats_attach(&psci_aff_map[idx].lock, "psci_aff_map", idx);
 
 	/*
 	 * If an affinity instance is present then mark it as OFF to begin with.
@@ -225,6 +269,11 @@ static void psci_init_aff_map_node(unsigned long mpidr,
 				      psci_svc_cpu_data.max_phys_off_afflvl,
 				      PSCI_INVALID_DATA);
 
+		/* The cpu has not been powered on yet */
+		set_cpu_data_by_index(linear_id,
+				      psci_svc_cpu_data.pcpu_init_done,
+				      0);
+
 		flush_cpu_data_by_index(linear_id, psci_svc_cpu_data);
 
 		cm_set_context_by_mpidr(mpidr,
@@ -315,6 +364,7 @@ int32_t psci_setup(void)
 {
 	unsigned long mpidr = read_mpidr();
 	int afflvl, affmap_idx, max_afflvl;
+	unsigned int linear_id;
 	aff_map_node_t *node;
 
 	psci_plat_pm_ops = NULL;
@@ -360,6 +410,29 @@ int32_t psci_setup(void)
 	flush_dcache_range((unsigned long) psci_aff_limits,
 			   sizeof(psci_aff_limits));
 
+	/*
+	 * Now that the topology tree is complete, record the nodes of each cpu
+	 * at all affinity levels in the per-cpu table. The table is flushed
+	 * for the same reason as 'psci_aff_limits'.
+	 */
+	for (affmap_idx = psci_aff_limits[MPIDR_AFFLVL0].min;
+	     affmap_idx <= psci_aff_limits[MPIDR_AFFLVL0].max;
+	     affmap_idx++) {
+		linear_id = platform_get_core_pos(
+					psci_aff_map[affmap_idx].mpidr);
+		assert(linear_id < PLATFORM_CORE_COUNT);
+
+		for (afflvl = MPIDR_AFFLVL0; afflvl <= max_afflvl; afflvl++) {
+			node = psci_get_aff_map_node(
+					psci_aff_map[affmap_idx].mpidr, afflvl);
+			assert(node);
+			psci_cpu_aff_map[linear_id][afflvl] = node;
+		}
+	}
+
+	flush_dcache_range((unsigned long) psci_cpu_aff_map,
+			   sizeof(psci_cpu_aff_map));
+
 	/*
 	 * Mark the affinity instances in our mpidr as ON. No need to lock as
 	 * this is the primary cpu.
@@ -388,6 +461,7 @@ int32_t psci_setup(void)
 	if (psci_plat_pm_ops->affinst_suspend &&
 			psci_plat_pm_ops->affinst_suspend_finish) {
 		psci_caps |=  define_psci_cap(PSCI_CPU_SUSPEND_AARCH64);
+		psci_caps |=  define_psci_cap(PSCI_SET_SUSPEND_MODE);
 		if (psci_plat_pm_ops->get_sys_suspend_power_state)
 			psci_caps |=  define_psci_cap(PSCI_SYSTEM_SUSPEND_AARCH64);
 	}
@@ -395,6 +469,10 @@ int32_t psci_setup(void)
 		psci_caps |=  define_psci_cap(PSCI_SYSTEM_OFF);
 	if (psci_plat_pm_ops->system_reset)
 		psci_caps |=  define_psci_cap(PSCI_SYSTEM_RESET);
+#if ENABLE_PSCI_STAT
+	psci_caps |=  define_psci_cap(PSCI_STAT_RESIDENCY_AARCH64);
+	psci_caps |=  define_psci_cap(PSCI_STAT_COUNT_AARCH64);
+#endif
 
 	return 0;
 }
@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <arch.h>
+#include <arch_helpers.h>
+#include <assert.h>
+#include <platform.h>
+#include <platform_def.h>
+#include <stdint.h>
+#include "psci_private.h"
+
+/*******************************************************************************
+ * Residency (in system counter ticks) and number of entries of a power state.
+ ******************************************************************************/
+typedef struct psci_stat {
+	uint64_t residency;
+	uint64_t count;
+} psci_stat_t;
+
+/*******************************************************************************
+ * Statistics of the standby state of each cpu, indexed by its linear id. The
+ * standby state is entered and exited by the cpu itself so no locking is
+ * required to update them.
+ ******************************************************************************/
+static psci_stat_t psci_cpu_standby_stat[PLATFORM_CORE_COUNT];
+
+/*******************************************************************************
+ * Statistics of the power down state of each affinity instance entered through
+ * a cpu_suspend call, indexed like 'psci_aff_map'. 'psci_aff_suspend_ts'
+ * holds the system counter value when the affinity instance was last powered
+ * down or 0 if it has not been powered down through a cpu_suspend call. These
+ * are only updated while holding the lock of the affinity instance.
+ ******************************************************************************/
+static psci_stat_t psci_aff_suspend_stat[PSCI_NUM_AFFS];
+static uint64_t psci_aff_suspend_ts[PSCI_NUM_AFFS];
+
+/*******************************************************************************
+ * This function accounts the time spent by the current cpu in a standby state
+ * since the system counter value 'entry_ts'.
+ ******************************************************************************/
+void psci_stats_update_standby(uint64_t entry_ts)
+{
+	psci_stat_t *stat;
+
+	stat = &psci_cpu_standby_stat[platform_get_core_pos(read_mpidr_el1())];
+	stat->residency += read_cntpct_el0() - entry_ts;
+	stat->count++;
+}
+
+/*******************************************************************************
+ * This function is called by a cpu which is about to suspend with the locks of
+ * the affinity instances in 'mpidr_nodes' held. It records the time at which
+ * each affinity instance up to 'max_phys_off_afflvl' is powered down.
+ ******************************************************************************/
+void psci_stats_update_pwr_down(aff_map_node_t *mpidr_nodes[],
+				uint32_t max_phys_off_afflvl)
+{
+	uint64_t ts;
+	uint32_t level;
+
+	ts = read_cntpct_el0();
+	for (level = MPIDR_AFFLVL0; level <= max_phys_off_afflvl; level++) {
+		if (mpidr_nodes[level] == NULL)
+			continue;
+
+		psci_aff_suspend_ts[mpidr_nodes[level] - psci_aff_map] = ts;
+	}
+}
+
+/*******************************************************************************
+ * This function is called by a cpu which has been physically powered on with
+ * the locks of the affinity instances in 'mpidr_nodes' held. It accounts the
+ * time spent in the power down state by each affinity instance up to
+ * 'max_phys_off_afflvl' which was powered down through a cpu_suspend call. The
+ * first cpu to power up an affinity instance does the accounting for it.
+ ******************************************************************************/
+void psci_stats_update_pwr_up(aff_map_node_t *mpidr_nodes[],
+			      uint32_t max_phys_off_afflvl)
+{
+	uint64_t ts;
+	uint32_t level, idx;
+
+	ts = read_cntpct_el0();
+	for (level = MPIDR_AFFLVL0; level <= max_phys_off_afflvl; level++) {
+		if (mpidr_nodes[level] == NULL)
+			continue;
+
+		idx = mpidr_nodes[level] - psci_aff_map;
+		if (psci_aff_suspend_ts[idx] == 0)
+			continue;
+
+		psci_aff_suspend_stat[idx].residency +=
+			ts - psci_aff_suspend_ts[idx];
+		psci_aff_suspend_stat[idx].count++;
+		psci_aff_suspend_ts[idx] = 0;
+	}
+}
+
+/*******************************************************************************
+ * This function returns the statistics of the power state 'power_state' as
+ * seen by the cpu 'target_cpu'. For a power down state, these are the
+ * statistics of the affinity instance at the affinity level in 'power_state'
+ * which contains the cpu. The state id in 'power_state' is platform specific
+ * and is not used to tell power states apart.
+ ******************************************************************************/
+static int psci_get_stat(unsigned long target_cpu,
+			 unsigned int power_state,
+			 psci_stat_t *stat)
+{
+	int rc;
+	unsigned int target_afflvl;
+	aff_map_node_t *node;
+
+	target_cpu &= MPIDR_AFFINITY_MASK;
+	if (psci_validate_mpidr(target_cpu, MPIDR_AFFLVL0) != PSCI_E_SUCCESS)
+		return PSCI_E_INVALID_PARAMS;
+
+	/* Check SBZ bits in power state are zero */
+	if (psci_validate_power_state(power_state))
+		return PSCI_E_INVALID_PARAMS;
+
+	/* Sanity check the requested state */
+	target_afflvl = psci_get_pstate_afflvl(power_state);
+	if (target_afflvl > get_max_afflvl())
+		return PSCI_E_INVALID_PARAMS;
+
+	/* Validate the power_state using platform pm_ops */
+	if (psci_plat_pm_ops->validate_power_state) {
+		rc = psci_plat_pm_ops->validate_power_state(power_state);
+		if (rc != PSCI_E_SUCCESS)
+			return PSCI_E_INVALID_PARAMS;
+	}
+
+	if (psci_get_pstate_type(power_state) == PSTATE_TYPE_STANDBY) {
+		*stat = psci_cpu_standby_stat[platform_get_core_pos(target_cpu)];
+		return PSCI_E_SUCCESS;
+	}
+
+	node = psci_get_aff_map_node(target_cpu, target_afflvl);
+	if (node == NULL || !(node->state & PSCI_AFF_PRESENT))
+		return PSCI_E_INVALID_PARAMS;
+
+	*stat = psci_aff_suspend_stat[node - psci_aff_map];
+	return PSCI_E_SUCCESS;
+}
+
+/*******************************************************************************
+ * PSCI_STAT_RESIDENCY: Returns the time in microseconds spent by 'target_cpu'
+ * in 'power_state' since cold boot, or 0 if the parameters are invalid.
+ ******************************************************************************/
+uint64_t psci_stat_residency(unsigned long target_cpu,
+			     unsigned int power_state)
+{
+	psci_stat_t stat;
+	uint64_t freq;
+
+	if (psci_get_stat(target_cpu, power_state, &stat) != PSCI_E_SUCCESS)
+		return 0;
+
+	/* Convert the ticks to microseconds without overflowing */
+	freq = plat_get_syscnt_freq();
+	assert(freq);
+	return (stat.residency / freq) * 1000000 +
+		((stat.residency % freq) * 1000000) / freq;
+}
+
+/*******************************************************************************
+ * PSCI_STAT_COUNT: Returns the number of times 'target_cpu' has entered
+ * 'power_state' since cold boot, or 0 if the parameters are invalid.
+ ******************************************************************************/
+uint64_t psci_stat_count(unsigned long target_cpu,
+			 unsigned int power_state)
+{
+	psci_stat_t stat;
+
+	if (psci_get_stat(target_cpu, power_state, &stat) != PSCI_E_SUCCESS)
+		return 0;
+
+	return stat.count;
+}